@@ -0,0 +1,403 @@
+// 渲染一致性与性能对比：对每个SVG文件分别经QSvgRenderer直接渲染、经SVGParser解析后逐个绘制ParseResult，
+// 比较两幅图像的像素差异，并记录两条路径的耗时与内存。
+// 用法：SVGBenchmark [--size N] [--iterations N] [--tolerance N] [--max-differing P] [--min-psnr DB]
+//                    [--stress N,N,...] [文件或目录...]
+// 未指定文件时使用源码目录下的SVGExample/。无显示环境时可加 -platform offscreen。
+// 任一文件加载失败、差异像素比例超过--max-differing或PSNR低于--min-psnr时，退出码非0。
+// 内存在单独的子进程中测量，各路径互不影响，也不受分配器复用已释放内存的干扰。
+
+#include "SVGParser.h"
+
+#include <QCommandLineParser>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QGuiApplication>
+#include <QImage>
+#include <QPainter>
+#include <QProcess>
+#include <QRandomGenerator>
+#include <QSvgRenderer>
+#include <QTemporaryDir>
+#include <QTextStream>
+
+#include <cmath>
+#include <cstdlib>
+
+#if defined(Q_OS_WIN)
+#define NOMINMAX
+#define PSAPI_VERSION 2
+#include <windows.h>
+#include <psapi.h>
+#elif defined(Q_OS_LINUX)
+#include <unistd.h>
+#endif
+
+// 当前进程的常驻内存(字节)。不支持的平台返回-1
+static qint64 residentMemory()
+{
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return static_cast<qint64>(counters.WorkingSetSize);
+    return -1;
+#elif defined(Q_OS_LINUX)
+    QFile statm {"/proc/self/statm"};
+    if (!statm.open(QIODevice::ReadOnly))
+        return -1;
+    QList<QByteArray> fields {statm.readAll().split(' ')};
+    if (fields.size() < 2)
+        return -1;
+    return fields[1].toLongLong() * sysconf(_SC_PAGESIZE);
+#else
+    return -1;
+#endif
+}
+
+struct PathMeasurement {
+    qint64 loadNs {-1}; // 加载(对SVGParser而言包括parse())的最短耗时
+    qint64 renderNs {-1}; // 渲染的最短耗时
+    qint64 memoryDelta {-1}; // 在新进程中加载前后常驻内存之差，近似值
+    QImage image;
+};
+
+struct ImageDifference {
+    double meanAbsolute {0}; // 各通道平均绝对差，0~255
+    int maxAbsolute {0}; // 各通道最大绝对差
+    double differingRatio {0}; // 任一通道之差超过容差的像素比例
+    double psnr {0}; // 峰值信噪比(dB)，完全相同时为无穷大
+};
+
+static QImage createCanvas(int size)
+{
+    QImage image {size, size, QImage::Format_ARGB32_Premultiplied};
+    image.fill(Qt::transparent);
+    return image;
+}
+
+static void updateMinimum(qint64 &minimum, qint64 value)
+{
+    if (minimum < 0 || value < minimum)
+        minimum = value;
+}
+
+static PathMeasurement measureRenderer(const QString &fileName, int size, int iterations)
+{
+    PathMeasurement measurement;
+    QElapsedTimer timer;
+
+    for (int i {0}; i < iterations; ++i) {
+        timer.start();
+
+        QSvgRenderer renderer;
+        renderer.setOptions(QtSvg::Tiny12FeaturesOnly); // 与SVGParser保持一致
+        if (!renderer.load(fileName))
+            return measurement;
+
+        updateMinimum(measurement.loadNs, timer.nsecsElapsed());
+
+        QImage image {createCanvas(size)};
+        timer.start();
+        QPainter painter {&image};
+        renderer.render(&painter, QRectF {0, 0, qreal(size), qreal(size)});
+        painter.end();
+        updateMinimum(measurement.renderNs, timer.nsecsElapsed());
+
+        measurement.image = image;
+    }
+
+    return measurement;
+}
+
+static PathMeasurement measureParser(const QString &fileName, int size, int iterations, qsizetype &elementCount)
+{
+    PathMeasurement measurement;
+    QElapsedTimer timer;
+
+    for (int i {0}; i < iterations; ++i) {
+        timer.start();
+
+        SVGParser parser;
+        if (!parser.loadSVG(fileName))
+            return measurement;
+        std::vector<SVGParser::ParseResult> parseResults {parser.parse()};
+        SVGParser::bakeTransforms(parseResults);
+
+        updateMinimum(measurement.loadNs, timer.nsecsElapsed());
+
+        // 按QSvgRenderer::render()的方式将viewBox映射到整幅图像
+        QRectF viewBox {parser.viewBoxF()};
+        QImage image {createCanvas(size)};
+        timer.start();
+        QPainter painter {&image};
+        painter.setRenderHint(QPainter::Antialiasing);
+        painter.setTransform(QTransform::fromTranslate(-viewBox.x(), -viewBox.y()) *
+                             QTransform::fromScale(size / viewBox.width(), size / viewBox.height()));
+        for (const auto &parseResult: parseResults) {
+            painter.setPen(parseResult.pen);
+            painter.setBrush(parseResult.brush);
+            painter.drawPath(parseResult.painterPath);
+        }
+        painter.end();
+        updateMinimum(measurement.renderNs, timer.nsecsElapsed());
+
+        measurement.image = image;
+        elementCount = static_cast<qsizetype>(parseResults.size());
+    }
+
+    return measurement;
+}
+
+// 子进程中执行：加载一次文件(对SVGParser而言包括parse())，返回加载前后常驻内存之差。失败时返回-1
+static qint64 probeMemory(const QString &path, const QString &fileName)
+{
+    const qint64 memoryBefore {residentMemory()};
+    if (memoryBefore < 0)
+        return -1;
+
+    if (path == "renderer") {
+        QSvgRenderer renderer;
+        renderer.setOptions(QtSvg::Tiny12FeaturesOnly);
+        if (!renderer.load(fileName))
+            return -1;
+        return residentMemory() - memoryBefore;
+    }
+
+    SVGParser parser;
+    if (!parser.loadSVG(fileName))
+        return -1;
+    std::vector<SVGParser::ParseResult> parseResults {parser.parse()};
+    SVGParser::bakeTransforms(parseResults);
+    return residentMemory() - memoryBefore;
+}
+
+// 以新进程运行probeMemory()，使两条路径都从干净的堆开始
+static qint64 measureMemory(const QString &path, const QString &fileName)
+{
+    QProcess process;
+    process.start(QCoreApplication::applicationFilePath(),
+                  {"-platform", QGuiApplication::platformName(), "--memory-probe", path, fileName});
+    if (!process.waitForFinished(-1) || process.exitStatus() != QProcess::NormalExit || process.exitCode() != 0)
+        return -1;
+
+    bool ok;
+    qint64 memoryDelta {process.readAllStandardOutput().trimmed().toLongLong(&ok)};
+    return ok ? memoryDelta : -1;
+}
+
+static ImageDifference compareImages(const QImage &a, const QImage &b, int tolerance)
+{
+    ImageDifference difference;
+    qint64 sumAbsolute {0};
+    qint64 sumSquared {0};
+    qint64 differingPixels {0};
+
+    for (int y {0}; y < a.height(); ++y) {
+        auto lineA {reinterpret_cast<const QRgb *>(a.constScanLine(y))};
+        auto lineB {reinterpret_cast<const QRgb *>(b.constScanLine(y))};
+        for (int x {0}; x < a.width(); ++x) {
+            const int channels[] {
+                    std::abs(qRed(lineA[x]) - qRed(lineB[x])),
+                    std::abs(qGreen(lineA[x]) - qGreen(lineB[x])),
+                    std::abs(qBlue(lineA[x]) - qBlue(lineB[x])),
+                    std::abs(qAlpha(lineA[x]) - qAlpha(lineB[x])),
+            };
+
+            int pixelMax {0};
+            for (int channel: channels) {
+                sumAbsolute += channel;
+                sumSquared += channel * channel;
+                pixelMax = std::max(pixelMax, channel);
+            }
+
+            difference.maxAbsolute = std::max(difference.maxAbsolute, pixelMax);
+            if (pixelMax > tolerance)
+                ++differingPixels;
+        }
+    }
+
+    const double samples {4.0 * a.width() * a.height()};
+    const double pixels {double(a.width()) * a.height()};
+    difference.meanAbsolute = sumAbsolute / samples;
+    difference.differingRatio = differingPixels / pixels;
+    difference.psnr = sumSquared == 0 ? INFINITY : 10 * std::log10(255.0 * 255.0 / (sumSquared / samples));
+    return difference;
+}
+
+// 生成压力测试文档：shapeCount个随机图形，分布在多层嵌套的<g>中，部分使用渐变填充
+static QString generateStressDocument(const QString &directory, int shapeCount)
+{
+    QString fileName {QDir {directory}.filePath(QString {"stress-%1.svg"}.arg(shapeCount))};
+    QFile file {fileName};
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+        return {};
+
+    QRandomGenerator random {quint32(shapeCount)}; // 固定种子，保证每次生成的文档相同
+    auto coordinate {[&] { return random.bounded(1000.0); }};
+    auto color {[&] { return QColor::fromRgb(random.bounded(256), random.bounded(256), random.bounded(256)).name(); }};
+
+    QTextStream out {&file};
+    out << R"(<svg xmlns="http://www.w3.org/2000/svg" version="1.2" baseProfile="tiny" viewBox="0 0 1000 1000">)" << '\n';
+
+    out << "<defs>\n";
+    for (int i {0}; i < 8; ++i) {
+        out << QString {R"(<linearGradient id="lg%1" x1="0" y1="0" x2="1" y2="1">)"}.arg(i)
+            << QString {R"(<stop offset="0" stop-color="%1"/><stop offset="1" stop-color="%2"/>)"}.arg(color(), color())
+            << "</linearGradient>\n";
+    }
+    out << "</defs>\n";
+
+    int depth {0};
+    for (int i {0}; i < shapeCount; ++i) {
+        // 随机进入或退出一层<g>，最深4层
+        if (depth < 4 && random.bounded(8) == 0) {
+            out << QString {R"(<g stroke="%1" stroke-width="%2" transform="translate(%3,%4)">)"}
+                            .arg(color())
+                            .arg(random.bounded(1, 4))
+                            .arg(random.bounded(-20, 20))
+                            .arg(random.bounded(-20, 20))
+                << '\n';
+            ++depth;
+        } else if (depth > 0 && random.bounded(8) == 0) {
+            out << "</g>\n";
+            --depth;
+        }
+
+        QString fill {random.bounded(4) == 0 ? QString {"url(#lg%1)"}.arg(random.bounded(8)) : color()};
+        switch (random.bounded(5)) {
+        case 0:
+            out << QString {R"(<rect x="%1" y="%2" width="%3" height="%4" fill="%5"/>)"}
+                            .arg(coordinate()).arg(coordinate()).arg(random.bounded(100.0)).arg(random.bounded(100.0)).arg(fill);
+            break;
+        case 1:
+            out << QString {R"(<circle cx="%1" cy="%2" r="%3" fill="%4"/>)"}
+                            .arg(coordinate()).arg(coordinate()).arg(random.bounded(50.0)).arg(fill);
+            break;
+        case 2:
+            out << QString {R"(<ellipse cx="%1" cy="%2" rx="%3" ry="%4" fill="%5"/>)"}
+                            .arg(coordinate()).arg(coordinate()).arg(random.bounded(50.0)).arg(random.bounded(50.0)).arg(fill);
+            break;
+        case 3:
+            out << QString {R"(<polyline points="%1,%2 %3,%4 %5,%6" fill="none" stroke="%7"/>)"}
+                            .arg(coordinate()).arg(coordinate()).arg(coordinate())
+                            .arg(coordinate()).arg(coordinate()).arg(coordinate()).arg(color());
+            break;
+        default:
+            out << QString {R"(<path d="M%1,%2 C%3,%4 %5,%6 %7,%8 Z" fill="%9"/>)"}
+                            .arg(coordinate()).arg(coordinate()).arg(coordinate()).arg(coordinate())
+                            .arg(coordinate()).arg(coordinate()).arg(coordinate()).arg(coordinate()).arg(fill);
+            break;
+        }
+        out << '\n';
+    }
+
+    for (; depth > 0; --depth)
+        out << "</g>\n";
+    out << "</svg>\n";
+
+    return fileName;
+}
+
+static QString formatMs(qint64 ns)
+{
+    return ns < 0 ? QString {"n/a"} : QString::number(ns / 1e6, 'f', 2);
+}
+
+static QString formatKiB(qint64 bytes)
+{
+    return bytes < 0 ? QString {"n/a"} : QString::number(bytes / 1024);
+}
+
+int main(int argc, char *argv[])
+{
+    QGuiApplication app {argc, argv};
+
+    QCommandLineParser commandLine;
+    commandLine.setApplicationDescription("Compare SVGParser results against QSvgRenderer.");
+    commandLine.addHelpOption();
+    QCommandLineOption sizeOption {"size", "Raster size in pixels.", "N", "512"};
+    QCommandLineOption iterationsOption {"iterations", "Timed iterations per file; the minimum is reported.", "N", "5"};
+    QCommandLineOption toleranceOption {"tolerance", "Per-channel difference above which a pixel counts as differing.", "N", "8"};
+    QCommandLineOption maxDifferingOption {"max-differing", "Fail when more than P percent of the pixels differ.", "P", "5"};
+    QCommandLineOption minPsnrOption {"min-psnr", "Fail when the PSNR is below DB decibels.", "DB", "20"};
+    QCommandLineOption stressOption {"stress", "Comma separated shape counts of generated stress documents.", "N,N,...", "1000,10000"};
+    QCommandLineOption memoryProbeOption {"memory-probe", "Internal: load one file and print the resident memory delta.", "renderer|parser"};
+    memoryProbeOption.setFlags(QCommandLineOption::HiddenFromHelp);
+    commandLine.addOptions({sizeOption, iterationsOption, toleranceOption, maxDifferingOption, minPsnrOption, stressOption, memoryProbeOption});
+    commandLine.addPositionalArgument("paths", "SVG files or directories. Defaults to SVGExample/.");
+    commandLine.process(app);
+
+    if (commandLine.isSet(memoryProbeOption)) {
+        const QStringList arguments {commandLine.positionalArguments()};
+        if (arguments.size() != 1)
+            return 1;
+        const qint64 memoryDelta {probeMemory(commandLine.value(memoryProbeOption), arguments.first())};
+        QTextStream {stdout} << memoryDelta << '\n';
+        return memoryDelta < 0 ? 1 : 0;
+    }
+
+    const int size {std::max(1, commandLine.value(sizeOption).toInt())};
+    const int iterations {std::max(1, commandLine.value(iterationsOption).toInt())};
+    const int tolerance {commandLine.value(toleranceOption).toInt()};
+    const double maxDiffering {commandLine.value(maxDifferingOption).toDouble()};
+    const double minPsnr {commandLine.value(minPsnrOption).toDouble()};
+
+    // 收集待测文件
+    QStringList paths {commandLine.positionalArguments()};
+    if (paths.isEmpty())
+        paths.append(SVG_EXAMPLE_DIR);
+
+    QStringList fileNames;
+    for (const QString &path: paths) {
+        QFileInfo info {path};
+        if (info.isDir()) {
+            for (const QFileInfo &entry: QDir {path}.entryInfoList({"*.svg"}, QDir::Files, QDir::Name))
+                fileNames.append(entry.filePath());
+        } else
+            fileNames.append(path);
+    }
+
+    QTemporaryDir stressDirectory;
+    const QString stressCounts {commandLine.value(stressOption)}; // tokenize()只保存视图，须保证字符串在循环期间存活
+    for (QStringView count: QStringView {stressCounts}.tokenize(u',', Qt::SkipEmptyParts)) {
+        QString fileName {generateStressDocument(stressDirectory.path(), count.toInt())};
+        if (!fileName.isEmpty())
+            fileNames.append(fileName);
+    }
+
+    QTextStream out {stdout};
+    out << "file\tresult\telements\tmeanDiff\tmaxDiff\tdiffering%\tpsnr\t"
+        << "rendererLoadMs\trendererRenderMs\trendererKiB\tparserLoadMs\tparserRenderMs\tparserKiB\n";
+
+    int failures {0};
+    for (const QString &fileName: fileNames) {
+        PathMeasurement renderer {measureRenderer(fileName, size, iterations)};
+        qsizetype elementCount {0};
+        PathMeasurement parser {measureParser(fileName, size, iterations, elementCount)};
+
+        if (renderer.image.isNull() || parser.image.isNull()) {
+            out << QFileInfo {fileName}.fileName() << "\tFAIL\tfailed to load\n";
+            ++failures;
+            continue;
+        }
+
+        renderer.memoryDelta = measureMemory("renderer", fileName);
+        parser.memoryDelta = measureMemory("parser", fileName);
+
+        ImageDifference difference {compareImages(renderer.image, parser.image, tolerance)};
+        const bool passed {difference.differingRatio * 100 <= maxDiffering && difference.psnr >= minPsnr};
+        if (!passed)
+            ++failures;
+
+        out << QFileInfo {fileName}.fileName() << '\t' << (passed ? "ok" : "FAIL") << '\t' << elementCount << '\t'
+            << QString::number(difference.meanAbsolute, 'f', 3) << '\t' << difference.maxAbsolute << '\t'
+            << QString::number(difference.differingRatio * 100, 'f', 2) << '\t'
+            << QString::number(difference.psnr, 'f', 2) << '\t'
+            << formatMs(renderer.loadNs) << '\t' << formatMs(renderer.renderNs) << '\t' << formatKiB(renderer.memoryDelta) << '\t'
+            << formatMs(parser.loadNs) << '\t' << formatMs(parser.renderNs) << '\t' << formatKiB(parser.memoryDelta) << '\n';
+        out.flush();
+    }
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// 有界无锁队列，支持多生产者多消费者。
+// 每个槽位带一个序号，生产者与消费者各自通过CAS推进位置，槽位序号用来判断该槽位当前可写还是可读。
+// push()/pop()在队列满/空时以std::atomic::wait()阻塞，不占用CPU；入队、出队计数即等待所用的序号。
+// reference: https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+template<typename T>
+class SVGBoundedQueue
+{
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        T value;
+    };
+
+    // 避免生产者与消费者的位置落在同一缓存行
+    static constexpr std::size_t CacheLineSize {64};
+
+    std::unique_ptr<Cell[]> m_cells;
+    std::size_t m_mask;
+    alignas(CacheLineSize) std::atomic<std::size_t> m_enqueuePos {0};
+    alignas(CacheLineSize) std::atomic<std::size_t> m_dequeuePos {0};
+    alignas(CacheLineSize) std::atomic<std::uint32_t> m_pushCount {0}; // 每次入队后递增并唤醒一个等待的消费者
+    alignas(CacheLineSize) std::atomic<std::uint32_t> m_popCount {0}; // 每次出队后递增并唤醒一个等待的生产者
+    std::atomic_bool m_closed {false};
+
+public:
+    // 容量向上取整为2的幂
+    explicit SVGBoundedQueue(std::size_t capacity);
+
+    SVGBoundedQueue(const SVGBoundedQueue &) = delete;
+    SVGBoundedQueue &operator=(const SVGBoundedQueue &) = delete;
+
+    // 队列满时返回false，且不会移动value
+    bool tryPush(T &&value);
+
+    // 队列空时返回false
+    bool tryPop(T &value);
+
+    // 队列满时阻塞直到有空位。队列已关闭时返回false，且不会移动value
+    bool push(T &&value);
+
+    // 队列空时阻塞直到有元素。队列已关闭且为空时返回false
+    bool pop(T &value);
+
+    // 关闭队列并唤醒所有等待者。此后push()返回false，仍可取出剩余元素。
+    // 所有生产者结束后调用时不会丢失元素；用于取消时，正在入队的元素可能取不出来
+    void close();
+
+    // 当前深度。并发访问时仅为近似值，用于统计
+    std::size_t size() const;
+
+    std::size_t capacity() const { return m_mask + 1; }
+};
+
+template<typename T>
+SVGBoundedQueue<T>::SVGBoundedQueue(std::size_t capacity)
+        : m_mask {std::bit_ceil(std::max(capacity, std::size_t {2})) - 1}
+{
+    m_cells = std::make_unique<Cell[]>(m_mask + 1);
+
+    for (std::size_t i {0}; i <= m_mask; ++i)
+        m_cells[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+template<typename T>
+bool SVGBoundedQueue<T>::tryPush(T &&value)
+{
+    Cell *cell;
+    std::size_t pos {m_enqueuePos.load(std::memory_order_relaxed)};
+
+    for (;;) {
+        cell = &m_cells[pos & m_mask];
+        std::size_t sequence {cell->sequence.load(std::memory_order_acquire)};
+        auto diff {static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos)};
+
+        if (diff == 0) {
+            if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        } else if (diff < 0)
+            return false; // 队列已满
+        else
+            pos = m_enqueuePos.load(std::memory_order_relaxed);
+    }
+
+    cell->value = std::move(value);
+    cell->sequence.store(pos + 1, std::memory_order_release);
+
+    m_pushCount.fetch_add(1, std::memory_order_release);
+    m_pushCount.notify_one();
+    return true;
+}
+
+template<typename T>
+bool SVGBoundedQueue<T>::tryPop(T &value)
+{
+    Cell *cell;
+    std::size_t pos {m_dequeuePos.load(std::memory_order_relaxed)};
+
+    for (;;) {
+        cell = &m_cells[pos & m_mask];
+        std::size_t sequence {cell->sequence.load(std::memory_order_acquire)};
+        auto diff {static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos + 1)};
+
+        if (diff == 0) {
+            if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        } else if (diff < 0)
+            return false; // 队列为空
+        else
+            pos = m_dequeuePos.load(std::memory_order_relaxed);
+    }
+
+    value = std::move(cell->value);
+    cell->sequence.store(pos + m_mask + 1, std::memory_order_release);
+
+    m_popCount.fetch_add(1, std::memory_order_release);
+    m_popCount.notify_one();
+    return true;
+}
+
+template<typename T>
+bool SVGBoundedQueue<T>::push(T &&value)
+{
+    for (;;) {
+        // 先读取序号再尝试入队：若两者之间有元素出队，序号已改变，wait()会立即返回，不会漏掉唤醒
+        std::uint32_t popCount {m_popCount.load(std::memory_order_acquire)};
+        if (m_closed.load(std::memory_order_acquire))
+            return false;
+        if (tryPush(std::move(value)))
+            return true;
+        m_popCount.wait(popCount, std::memory_order_acquire);
+    }
+}
+
+template<typename T>
+bool SVGBoundedQueue<T>::pop(T &value)
+{
+    for (;;) {
+        std::uint32_t pushCount {m_pushCount.load(std::memory_order_acquire)};
+        if (tryPop(value))
+            return true;
+        if (m_closed.load(std::memory_order_acquire))
+            return tryPop(value);
+        m_pushCount.wait(pushCount, std::memory_order_acquire);
+    }
+}
+
+template<typename T>
+void SVGBoundedQueue<T>::close()
+{
+    m_closed.store(true, std::memory_order_release);
+
+    // 改变序号，使已读取旧序号、尚未进入等待的线程也不会阻塞
+    m_pushCount.fetch_add(1, std::memory_order_release);
+    m_popCount.fetch_add(1, std::memory_order_release);
+    m_pushCount.notify_all();
+    m_popCount.notify_all();
+}
+
+template<typename T>
+std::size_t SVGBoundedQueue<T>::size() const
+{
+    std::size_t dequeuePos {m_dequeuePos.load(std::memory_order_relaxed)};
+    std::size_t enqueuePos {m_enqueuePos.load(std::memory_order_relaxed)};
+    return enqueuePos > dequeuePos ? enqueuePos - dequeuePos : 0;
+}
@@ -20,8 +20,11 @@ void SVGBrush::parseFill(QStringView fill, const GradientMap &gradientMap)
             QBrush::operator=(std::get<QRadialGradient>(gradient));
 
     } else {
+        // 保留已继承的fill-opacity
+        QColor color {QColor::fromString(fill)};
+        color.setAlphaF(QBrush::color().alphaF());
         setStyle(Qt::SolidPattern);
-        setColor(QColor::fromString(fill));
+        setColor(color);
     }
 }
 
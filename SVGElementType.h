@@ -0,0 +1,83 @@
+#pragma once
+
+#include <QStringView>
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+// 解析器认识的SVG元素。不在此列的标签一律视为Unknown
+enum class SVGElementType : std::uint8_t
+{
+    Unknown,
+    Svg,
+    G,
+    Defs,
+    LinearGradient,
+    RadialGradient,
+    Stop,
+    Rect,
+    Circle,
+    Ellipse,
+    Line,
+    Polyline,
+    Polygon,
+    Path,
+};
+
+// SVGElementType的取值个数，可用作以元素类型为下标的数组大小
+inline constexpr std::size_t svgElementTypeCount {static_cast<std::size_t>(SVGElementType::Path) + 1};
+
+struct SVGElementName {
+    std::u16string_view name;
+    SVGElementType type {SVGElementType::Unknown};
+};
+
+inline constexpr std::array<SVGElementName, 13> svgElementNames {{
+        {u"svg", SVGElementType::Svg},
+        {u"g", SVGElementType::G},
+        {u"defs", SVGElementType::Defs},
+        {u"linearGradient", SVGElementType::LinearGradient},
+        {u"radialGradient", SVGElementType::RadialGradient},
+        {u"stop", SVGElementType::Stop},
+        {u"rect", SVGElementType::Rect},
+        {u"circle", SVGElementType::Circle},
+        {u"ellipse", SVGElementType::Ellipse},
+        {u"line", SVGElementType::Line},
+        {u"polyline", SVGElementType::Polyline},
+        {u"polygon", SVGElementType::Polygon},
+        {u"path", SVGElementType::Path},
+}};
+
+// 以标签长度和首字符计算的完美哈希，对svgElementNames中的名字两两不冲突(由下方static_assert保证)
+constexpr std::size_t svgElementHash(std::size_t size, char16_t first)
+{
+    return (2 * size + first) & 31;
+}
+
+inline constexpr std::array<SVGElementName, 32> svgElementTable {[] {
+    std::array<SVGElementName, 32> table {};
+    for (const auto &entry: svgElementNames)
+        table[svgElementHash(entry.name.size(), entry.name.front())] = entry;
+    return table;
+}()};
+
+static_assert([] {
+    std::size_t occupied {0};
+    for (const auto &entry: svgElementTable)
+        if (!entry.name.empty()) ++occupied;
+    return occupied == svgElementNames.size();
+}(), "svgElementHash must be collision-free over svgElementNames");
+
+// 由标签名取得元素类型：一次查表加一次字符串比较，代替逐个比较标签名
+inline SVGElementType svgElementType(QStringView tagName)
+{
+    if (tagName.isEmpty())
+        return SVGElementType::Unknown;
+
+    const SVGElementName &entry {svgElementTable[svgElementHash(tagName.size(), tagName.front().unicode())]};
+    if (tagName == QStringView {entry.name.data(), static_cast<qsizetype>(entry.name.size())})
+        return entry.type;
+
+    return SVGElementType::Unknown;
+}
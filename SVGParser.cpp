@@ -1,17 +1,145 @@
 #include "SVGParser.h"
 
+#include "SVGBoundedQueue.h"
+
 #include <QBuffer>
+#include <QFile>
+#include <QFileInfo>
+#include <QHashFunctions>
 #include <QPainter>
 #include <QRegularExpression>
 #include <QSvgGenerator>
+#include <QThread>
+#include <QXmlStreamReader>
+
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <utility>
+
+// 离开作用域时调用onExit，用于在异常路径上收尾
+template<typename OnExit>
+class SVGScopeGuard
+{
+    OnExit m_onExit;
+
+public:
+    explicit SVGScopeGuard(OnExit onExit)
+            : m_onExit {std::move(onExit)} {}
+
+    SVGScopeGuard(const SVGScopeGuard &) = delete;
+    SVGScopeGuard &operator=(const SVGScopeGuard &) = delete;
+
+    ~SVGScopeGuard() { m_onExit(); }
+};
+
+// 路径数据或点列中命令与数值的个数，用于在不构建路径的情况下估计其规模
+static qint64 countPathTokens(QStringView data)
+{
+    qint64 count {0};
+    bool inNumber {false};
+    QChar previous;
+
+    for (QChar c: data) {
+        if (c.isDigit() || c == '.') {
+            if (!inNumber) {
+                ++count;
+                inNumber = true;
+            }
+        } else if (c == '+' || c == '-') {
+            if (!(inNumber && (previous == 'e' || previous == 'E'))) { // 指数的符号不开始新的数
+                ++count;
+                inNumber = true;
+            }
+        } else if (inNumber && (c == 'e' || c == 'E')) {
+            // 指数部分，仍属于当前数
+        } else {
+            if (c.isLetter())
+                ++count; // 命令字母
+            inNumber = false;
+        }
+        previous = c;
+    }
+
+    return count;
+}
+
+bool SVGParser::needsSourceScan() const
+{
+    constexpr qint64 unlimited {std::numeric_limits<qint64>::max()};
+    return m_limits.maxElementCount != unlimited || m_limits.maxPathCommandCount != unlimited ||
+           m_limits.maxGradientStopCount != unlimited || m_limits.maxDuration != std::chrono::milliseconds::max();
+}
+
+bool SVGParser::scanSourceBudget(const QString &fileName)
+{
+    QFile file {fileName};
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Failed to open file for scanning";
+        return false;
+    }
+
+    QXmlStreamReader reader {&file};
+    while (!reader.atEnd()) {
+        if (reader.readNext() != QXmlStreamReader::StartElement) continue;
+
+        consumeElements(1);
+        switch (svgElementType(reader.name())) {
+        case SVGElementType::Path:
+            consumePathCommands(countPathTokens(reader.attributes().value(u"d")));
+            break;
+        case SVGElementType::Polyline:
+        case SVGElementType::Polygon:
+            consumePathCommands(countPathTokens(reader.attributes().value(u"points")));
+            break;
+        case SVGElementType::Stop:
+            consumeGradientStops(1);
+            break;
+        default:
+            break;
+        }
+
+        if (budgetExceeded()) {
+            qWarning() << "SVG file exceeds the budget:" << error();
+            return false;
+        }
+    }
+
+    // 无法按XML读取的输入(如gzip压缩的.svgz)无法检查预算，一律拒绝
+    if (reader.hasError()) {
+        fail(ParseError::InvalidDocument);
+        qWarning() << "Failed to scan SVG XML data:" << reader.errorString();
+        return false;
+    }
+
+    return true;
+}
 
 bool SVGParser::loadSVG(const QString &fileName)
 {
+    resetBudget();
+
+    // Check file size before reading anything.
+    if (QFileInfo {fileName}.size() > m_limits.maxFileSize) {
+        fail(ParseError::FileTooLarge);
+        qWarning() << "SVG file exceeds the size limit";
+        return false;
+    }
+
+    // Stream through the source file first, so that documents over the budget are rejected
+    // before QSvgRenderer, QSvgGenerator and QDomDocument build them in full.
+    if (needsSourceScan() && !scanSourceBudget(fileName))
+        return false;
+
     // Load on QSvgRenderer.
     if (!m_renderer.load(fileName)) {
         qWarning() << "Failed to load file on m_renderer";
         return false;
     }
+    if (budgetExceeded()) {
+        qWarning() << "SVG file exceeds the budget:" << error();
+        return false;
+    }
 
     // Create QBuffer as I/O device.
     QBuffer svgBuffer;
@@ -31,6 +159,11 @@ bool SVGParser::loadSVG(const QString &fileName)
     m_renderer.render(&painter, m_renderer.viewBoxF()); // 显式指定渲染范围，解决了因“同时指定了viewBox和size属性”时引起的svg缩放而导致只渲染部分区域的问题
     painter.end();
 
+    if (budgetExceeded()) {
+        qWarning() << "SVG file exceeds the budget:" << error();
+        return false;
+    }
+
     // Set current position to 0.
     svgBuffer.seek(0);
 
@@ -43,23 +176,27 @@ bool SVGParser::loadSVG(const QString &fileName)
     // Close svgBuffer.
     svgBuffer.close();
 
+    if (budgetExceeded()) {
+        qWarning() << "SVG file exceeds the budget:" << error();
+        return false;
+    }
+
     return true;
 }
 
-QDomNamedNodeMap SVGParser::parseG(const QDomElement &e, const QDomNamedNodeMap &inheritedAttributes)
+SVGParser::ParseResult SVGParser::parseG(const QDomElement &e, const ParseResult &inheritedStyle) const
 {
+    // 只应用本层的属性(相对于上层的增量)，无需复制整个属性集。
+    // SVGPen/SVGBrush/SVGPainterPath均为隐式共享，复制上层样式的开销很小。
+    ParseResult style {inheritedStyle};
     QDomNamedNodeMap localAttributes {e.attributes()};
 
-    QDomElement elementForResult {m_doc.createElement("elementForResult")};
-    QDomNamedNodeMap result {elementForResult.attributes()};
-
-    for (int i {0}; i < inheritedAttributes.count(); ++i)
-        result.setNamedItem(inheritedAttributes.item(i));
+    style.pen.syncWithAttributes(localAttributes);
+    style.brush.syncWithAttributes(localAttributes, m_globalGradients);
+    style.painterPath.syncWithAttributes(localAttributes);
+    style.transform.syncWithAttributes(localAttributes);
 
-    for (int i {0}; i < localAttributes.count(); ++i)
-        result.setNamedItem(localAttributes.item(i));
-
-    return result;
+    return style;
 }
 
 SVGParser::GradientMap SVGParser::parseGradients(const QDomElement &e) const
@@ -76,35 +213,37 @@ SVGParser::GradientMap SVGParser::parseGradients(const QDomElement &e) const
         return map;
 
     for (const auto &childNode: childNodes) {
+        if (budgetExceeded()) break;
+
         assert(childNode.isElement());
         auto childElement {childNode.toElement()};
-        if (childElement.tagName() == "linearGradient") {
+        switch (svgElementType(childElement.tagName())) {
+        case SVGElementType::LinearGradient: {
             QString id {childElement.attribute("id")};
             auto linearGradient {parseLinearGradient(childElement)};
             map.insert({id, linearGradient});
-        } else if (childElement.tagName() == "radialGradient") {
+            break;
+        }
+        case SVGElementType::RadialGradient: {
             QString id {childElement.attribute("id")};
             auto radialGradient {parseRadialGradient(childElement)};
             map.insert({id, radialGradient});
+            break;
+        }
+        default:
+            break;
         }
     }
 
     return map;
 }
 
-SVGParser::ParseResult SVGParser::parseRect(const QDomElement &e, const QDomNamedNodeMap &inheritedAttributes) const
+SVGParser::ParseResult SVGParser::parseRect(const QDomElement &e, const ParseResult &inheritedStyle) const
 {
-    ParseResult parseResult;
+    // inherit resolved style
+    ParseResult parseResult {inheritedStyle};
     SVGPen &pen {parseResult.pen};
-    SVGBrush &brush {parseResult.brush};
     SVGPainterPath &path {parseResult.painterPath};
-    SVGTransform &transform {parseResult.transform};
-
-    // parse inherited attributes
-    pen.syncWithAttributes(inheritedAttributes);
-    brush.syncWithAttributes(inheritedAttributes, m_globalGradients);
-    path.syncWithAttributes(inheritedAttributes);
-    transform.syncWithAttributes(inheritedAttributes);
 
     // 获取元素的属性。如果属性值无效或不存在该属性，则结果为0。
     qreal x {e.attribute("x").toDouble()};
@@ -121,19 +260,12 @@ SVGParser::ParseResult SVGParser::parseRect(const QDomElement &e, const QDomName
     return parseResult;
 }
 
-SVGParser::ParseResult SVGParser::parseEllipse(const QDomElement &e, const QDomNamedNodeMap &inheritedAttributes) const
+SVGParser::ParseResult SVGParser::parseEllipse(const QDomElement &e, const ParseResult &inheritedStyle) const
 {
-    ParseResult parseResult;
+    // inherit resolved style
+    ParseResult parseResult {inheritedStyle};
     SVGPen &pen {parseResult.pen};
-    SVGBrush &brush {parseResult.brush};
     SVGPainterPath &path {parseResult.painterPath};
-    SVGTransform &transform {parseResult.transform};
-
-    // parse inherited attributes
-    pen.syncWithAttributes(inheritedAttributes);
-    brush.syncWithAttributes(inheritedAttributes, m_globalGradients);
-    path.syncWithAttributes(inheritedAttributes);
-    transform.syncWithAttributes(inheritedAttributes);
 
     // 获取元素的属性。如果属性值无效或不存在该属性，则结果为0。
     qreal cx {e.attribute("cx").toDouble()};
@@ -150,19 +282,12 @@ SVGParser::ParseResult SVGParser::parseEllipse(const QDomElement &e, const QDomN
     return parseResult;
 }
 
-SVGParser::ParseResult SVGParser::parseCircle(const QDomElement &e, const QDomNamedNodeMap &inheritedAttributes) const
+SVGParser::ParseResult SVGParser::parseCircle(const QDomElement &e, const ParseResult &inheritedStyle) const
 {
-    ParseResult parseResult;
+    // inherit resolved style
+    ParseResult parseResult {inheritedStyle};
     SVGPen &pen {parseResult.pen};
-    SVGBrush &brush {parseResult.brush};
     SVGPainterPath &path {parseResult.painterPath};
-    SVGTransform &transform {parseResult.transform};
-
-    // parse inherited attributes
-    pen.syncWithAttributes(inheritedAttributes);
-    brush.syncWithAttributes(inheritedAttributes, m_globalGradients);
-    path.syncWithAttributes(inheritedAttributes);
-    transform.syncWithAttributes(inheritedAttributes);
 
     // 获取元素的属性。如果属性值无效或不存在该属性，则结果为0。
     qreal cx {e.attribute("cx").toDouble()};
@@ -178,19 +303,13 @@ SVGParser::ParseResult SVGParser::parseCircle(const QDomElement &e, const QDomNa
     return parseResult;
 }
 
-SVGParser::ParseResult SVGParser::parsePolyline(const QDomElement &e, const QDomNamedNodeMap &inheritedAttributes) const
+SVGParser::ParseResult SVGParser::parsePolyline(const QDomElement &e, const ParseResult &inheritedStyle) const
 {
-    ParseResult parseResult;
+    // inherit resolved style
+    ParseResult parseResult {inheritedStyle};
     SVGPen &pen {parseResult.pen};
     SVGBrush &brush {parseResult.brush};
     SVGPainterPath &path {parseResult.painterPath};
-    SVGTransform &transform {parseResult.transform};
-
-    // parse inherited attributes
-    pen.syncWithAttributes(inheritedAttributes);
-    brush.syncWithAttributes(inheritedAttributes, m_globalGradients);
-    path.syncWithAttributes(inheritedAttributes);
-    transform.syncWithAttributes(inheritedAttributes);
 
     // 获取并解析元素的属性。如果不存在该属性，则结果为空字符串。
     // reference: https://www.w3.org/TR/SVGTiny12/shapes.html#PolylineElement
@@ -201,6 +320,10 @@ SVGParser::ParseResult SVGParser::parsePolyline(const QDomElement &e, const QDom
 
         assert(stringList.size() % 2 == 0);
 
+        // 在构建路径之前消耗预算，超出时不再构建
+        if (!consumeMemory(stringList.size() / 2 * sizeof(QPainterPath::Element)))
+            return parseResult;
+
         double x0 {stringList[0].toDouble()};
         double y0 {stringList[1].toDouble()};
         path.moveTo(x0, y0);
@@ -219,19 +342,12 @@ SVGParser::ParseResult SVGParser::parsePolyline(const QDomElement &e, const QDom
     return parseResult;
 }
 
-SVGParser::ParseResult SVGParser::parsePath(const QDomElement &e, const QDomNamedNodeMap &inheritedAttributes) const
+SVGParser::ParseResult SVGParser::parsePath(const QDomElement &e, const ParseResult &inheritedStyle) const
 {
-    ParseResult parseResult;
+    // inherit resolved style
+    ParseResult parseResult {inheritedStyle};
     SVGPen &pen {parseResult.pen};
-    SVGBrush &brush {parseResult.brush};
     SVGPainterPath &path {parseResult.painterPath};
-    SVGTransform &transform {parseResult.transform};
-
-    // parse inherited attributes
-    pen.syncWithAttributes(inheritedAttributes);
-    brush.syncWithAttributes(inheritedAttributes, m_globalGradients);
-    path.syncWithAttributes(inheritedAttributes);
-    transform.syncWithAttributes(inheritedAttributes);
 
     // 获取并解析元素的属性。如果不存在该属性，则结果为空字符串。
     // reference: https://www.w3.org/TR/SVGTiny12/paths.html
@@ -239,6 +355,11 @@ SVGParser::ParseResult SVGParser::parsePath(const QDomElement &e, const QDomName
     QStringView dView {d};
     if (!dView.isEmpty()) {
         QList<QStringView> stringList {dView.split(' ', Qt::SkipEmptyParts)};
+
+        // 在构建路径之前消耗预算，超出时不再构建
+        if (!consumeMemory(stringList.size() * sizeof(QPainterPath::Element)))
+            return parseResult;
+
         path.reserve(static_cast<int>(stringList.size()));
 
         auto it {stringList.begin()};
@@ -287,7 +408,8 @@ SVGParser::ParseResult SVGParser::parsePath(const QDomElement &e, const QDomName
                 ++it;
 
                 path.cubicTo(ctrlPt1, ctrlPt2, endPt);
-            }
+            } else
+                ++it; // 跳过无法识别的内容，避免死循环
         }
     }
 
@@ -384,39 +506,319 @@ SVGParser::SVGParser()
     // 这样做是为了避免Qt将复杂的标签强行解析为<image>标签，这样的图元缩放会失真
 }
 
+bool SVGParser::isParsedElement(SVGElementType type)
+{
+    switch (type) {
+    case SVGElementType::Rect:
+    case SVGElementType::Ellipse:
+    case SVGElementType::Circle:
+    case SVGElementType::Polyline:
+    case SVGElementType::Path:
+        return true;
+    default:
+        return false;
+    }
+}
+
+SVGParser::ParseResult SVGParser::parseElement(SVGElementType type, const QDomElement &e, const ParseResult &inheritedStyle) const
+{
+    switch (type) {
+    case SVGElementType::Rect:
+        return parseRect(e, inheritedStyle);
+    case SVGElementType::Ellipse:
+        return parseEllipse(e, inheritedStyle);
+    case SVGElementType::Circle:
+        return parseCircle(e, inheritedStyle);
+    case SVGElementType::Polyline:
+        return parsePolyline(e, inheritedStyle);
+    case SVGElementType::Path:
+        return parsePath(e, inheritedStyle);
+    default:
+        assert(false);
+        return ParseResult {};
+    }
+}
+
 std::vector<SVGParser::ParseResult> SVGParser::parse()
 {
+    return parseWith([this](SVGElementType type, const QDomElement &e, const ParseResult &inheritedStyle) {
+        return parseElement(type, e, inheritedStyle);
+    });
+}
+
+std::vector<SVGParser::ParseResult> SVGParser::parseConcurrently(int workerCount, qsizetype queueCapacity,
+                                                                 const std::function<void(const ParseResult &)> &onResult)
+{
+    // 工作线程只对DOM做只读访问(QDomNode的引用计数是原子的)，m_globalGradients在第一个任务入队前已解析完毕
+
+    if (workerCount <= 0)
+        workerCount = QThread::idealThreadCount();
+
+    resetBudget();
+
+    struct Task {
+        qsizetype index {0};
+        SVGElementType type {SVGElementType::Unknown};
+        QDomElement element;
+        ParseResult inheritedStyle;
+    };
+
+    struct Output {
+        qsizetype index {0};
+        ParseResult parseResult;
+    };
+
+    struct Counters {
+        std::atomic<qsizetype> peakTaskQueueDepth {0};
+        std::atomic<qsizetype> peakResultQueueDepth {0};
+        std::atomic<qsizetype> taskQueueFullWaits {0};
+        std::atomic<qsizetype> resultQueueFullWaits {0};
+    };
+
+    auto recordDepth {[](std::atomic<qsizetype> &peak, std::size_t depth) {
+        qsizetype current {peak.load(std::memory_order_relaxed)};
+        while (static_cast<qsizetype>(depth) > current &&
+               !peak.compare_exchange_weak(current, static_cast<qsizetype>(depth), std::memory_order_relaxed)) {}
+    }};
+
+    // 容量至少为1，避免负数转换为size_t
+    queueCapacity = std::max(queueCapacity, qsizetype {1});
+    SVGBoundedQueue<Task> tasks {static_cast<std::size_t>(queueCapacity)};
+    SVGBoundedQueue<Output> outputs {static_cast<std::size_t>(queueCapacity)};
+    Counters counters;
+    qsizetype taskCount {0};
+    std::atomic_int runningWorkers {workerCount};
+
+    // 各阶段在队列满/空时阻塞等待，不空转。
+    // 遍历线程与工作线程中抛出的异常记录为错误，而不是让异常离开std::jthread(会调用std::terminate())；
+    // 此后各阶段继续排空队列以便正常结束，结果被丢弃。
+    std::atomic_bool cancelled {false}; // 为true时各阶段丢弃剩余工作，不记录解析错误
+    auto cancel {[&] {
+        cancelled.store(true, std::memory_order_relaxed);
+        tasks.close(); // 关闭后push()立即返回false，pop()取完剩余元素后返回false，均不再阻塞
+        outputs.close();
+    }};
+
+    // 线程对象先于守卫构造、后于守卫析构：创建线程或收集结果时抛出异常，守卫先关闭两个队列，
+    // 使各线程都能退出，随后std::jthread析构时的join()不会永远等待
+    std::jthread traversalThread;
+    std::vector<std::jthread> workers;
+    SVGScopeGuard cancelOnExit {cancel};
+
+    // 阶段1：遍历文档、解析<defs>与各层<g>的样式，将图形元素分发给工作线程
+    traversalThread = std::jthread {[&] {
+        try {
+            traverse([&](SVGElementType type, const QDomElement &e, const ParseResult &inheritedStyle) {
+                if (!isParsedElement(type) || cancelled.load(std::memory_order_relaxed)) return;
+
+                Task task {taskCount++, type, e, inheritedStyle};
+                if (!tasks.tryPush(std::move(task))) {
+                    counters.taskQueueFullWaits.fetch_add(1, std::memory_order_relaxed);
+                    tasks.push(std::move(task));
+                }
+                recordDepth(counters.peakTaskQueueDepth, tasks.size());
+            });
+        } catch (const std::exception &exception) {
+            fail(ParseError::InvalidDocument);
+            qWarning() << "Exception while traversing SVG:" << exception.what();
+        }
+        tasks.close(); // 工作线程取完剩余任务后退出
+    }};
+
+    // 阶段2：工作线程构建SVGPen/SVGBrush/SVGPainterPath
+    workers.reserve(workerCount);
+    for (int i {0}; i < workerCount; ++i) {
+        workers.emplace_back([&] {
+            Task task;
+            while (tasks.pop(task)) {
+                // 取消或超出预算后丢弃剩余任务，遍历线程随即停止
+                if (cancelled.load(std::memory_order_relaxed) || budgetExceeded()) continue;
+
+                Output output {task.index};
+                try {
+                    output.parseResult = parseElement(task.type, task.element, task.inheritedStyle);
+                } catch (const std::exception &exception) {
+                    fail(ParseError::InvalidDocument);
+                    qWarning() << "Exception while parsing SVG element:" << exception.what();
+                    continue;
+                }
+
+                if (!outputs.tryPush(std::move(output))) {
+                    counters.resultQueueFullWaits.fetch_add(1, std::memory_order_relaxed);
+                    outputs.push(std::move(output));
+                }
+                recordDepth(counters.peakResultQueueDepth, outputs.size());
+            }
+
+            // 最后一个退出的工作线程关闭结果队列
+            if (runningWorkers.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                outputs.close();
+        });
+    }
+
+    // 阶段3：调用线程收集结果，按文档顺序放回。
+    // onResult抛出的异常属于调用者，不记录为解析错误：取消其余阶段，排空队列，在各线程结束后重新抛出
     std::vector<ParseResult> parseResults;
-    QDomElement SVGNode {this->SVGNode()};
-
-    // 解析<defs>元素结点
-    QDomElement defsNode {SVGNode.firstChildElement("defs")};
-    m_globalGradients = parseGradients(defsNode);
-
-    // 开始解析图形元素
-    QDomElement outerGNode {SVGNode.firstChildElement("g")};
-    QDomNamedNodeMap outerAttributes {outerGNode.attributes()};
-
-    QDomNodeList innerGNodes {outerGNode.childNodes()};
-
-    for (const QDomNode &innerGNode: innerGNodes) {
-        QDomElement itemNode {innerGNode.firstChild().toElement()};
-        if (itemNode.isNull()) continue;
-
-        QDomNamedNodeMap attributes {parseG(innerGNode.toElement(), outerAttributes)};
-
-        QString itemType {itemNode.tagName()};
-        if (itemType == "rect")
-            parseResults.push_back(parseRect(itemNode, attributes));
-        else if (itemType == "ellipse")
-            parseResults.push_back(parseEllipse(itemNode, attributes));
-        else if (itemType == "circle")
-            parseResults.push_back(parseCircle(itemNode, attributes));
-        else if (itemType == "polyline")
-            parseResults.push_back(parsePolyline(itemNode, attributes));
-        else if (itemType == "path")
-            parseResults.push_back(parsePath(itemNode, attributes));
+    std::exception_ptr onResultException;
+    Output output;
+    while (outputs.pop(output)) {
+        if (onResultException) continue;
+
+        if (onResult) {
+            try {
+                onResult(output.parseResult);
+            } catch (...) {
+                onResultException = std::current_exception();
+                cancel();
+                continue;
+            }
+        }
+
+        if (output.index >= static_cast<qsizetype>(parseResults.size()))
+            parseResults.resize(output.index + 1);
+        parseResults[output.index] = std::move(output.parseResult);
+    }
+
+    traversalThread.join();
+    for (auto &worker: workers)
+        worker.join();
+
+    m_pipelineStats.taskCount = taskCount;
+    m_pipelineStats.peakTaskQueueDepth = counters.peakTaskQueueDepth.load(std::memory_order_relaxed);
+    m_pipelineStats.peakResultQueueDepth = counters.peakResultQueueDepth.load(std::memory_order_relaxed);
+    m_pipelineStats.taskQueueFullWaits = counters.taskQueueFullWaits.load(std::memory_order_relaxed);
+    m_pipelineStats.resultQueueFullWaits = counters.resultQueueFullWaits.load(std::memory_order_relaxed);
+
+    if (onResultException)
+        std::rethrow_exception(onResultException);
+
+    if (error() != ParseError::NoError) {
+        qWarning() << "Parsing aborted:" << error();
+        return {};
     }
 
     return parseResults;
 }
+
+std::size_t SVGParser::contentKey(const QPen &pen, const QBrush &brush, const QPainterPath &path)
+{
+    auto hashBrush {[](std::size_t seed, const QBrush &brush) {
+        seed = qHashMulti(seed, static_cast<int>(brush.style()), quint64 {brush.color().rgba64()});
+
+        const QGradient *gradient {brush.gradient()};
+        if (!gradient)
+            return seed;
+
+        seed = qHashMulti(seed, static_cast<int>(gradient->type()), static_cast<int>(gradient->coordinateMode()),
+                          static_cast<int>(gradient->spread()));
+        switch (gradient->type()) {
+        case QGradient::LinearGradient: {
+            auto linearGradient {static_cast<const QLinearGradient *>(gradient)};
+            seed = qHashMulti(seed, linearGradient->start().x(), linearGradient->start().y(),
+                              linearGradient->finalStop().x(), linearGradient->finalStop().y());
+            break;
+        }
+        case QGradient::RadialGradient: {
+            auto radialGradient {static_cast<const QRadialGradient *>(gradient)};
+            seed = qHashMulti(seed, radialGradient->center().x(), radialGradient->center().y(), radialGradient->radius(),
+                              radialGradient->focalPoint().x(), radialGradient->focalPoint().y());
+            break;
+        }
+        default:
+            break;
+        }
+
+        for (const auto &[position, color]: gradient->stops())
+            seed = qHashMulti(seed, position, quint64 {color.rgba64()});
+        return seed;
+    }};
+
+    std::size_t seed {qHashMulti(0, pen.widthF(), static_cast<int>(pen.style()), static_cast<int>(pen.capStyle()),
+                                 static_cast<int>(pen.joinStyle()), pen.miterLimit(), pen.dashOffset(), pen.isCosmetic())};
+    for (qreal dash: pen.dashPattern())
+        seed = qHash(dash, seed);
+    seed = hashBrush(seed, pen.brush());
+    seed = hashBrush(seed, brush);
+
+    seed = qHashMulti(seed, static_cast<int>(path.fillRule()), path.elementCount());
+    for (int i {0}; i < path.elementCount(); ++i) {
+        const QPainterPath::Element &element {path.elementAt(i)};
+        seed = qHashMulti(seed, static_cast<int>(element.type), element.x, element.y);
+    }
+
+    return seed;
+}
+
+void SVGParser::bakeTransforms(std::vector<ParseResult> &parseResults)
+{
+    for (auto &parseResult: parseResults) {
+        SVGTransform &transform {parseResult.transform};
+        if (transform.isIdentity()) continue;
+
+        // QTransform::map()已对单位变换与平移做了特殊处理
+        parseResult.painterPath.QPainterPath::operator=(transform.map(parseResult.painterPath));
+
+        // userSpaceOnUse的渐变坐标位于路径的坐标系中，随路径一起变换；objectBoundingBox的渐变随包围盒变化，无需处理
+        SVGBrush &brush {parseResult.brush};
+        if (brush.gradient() && brush.gradient()->coordinateMode() == QGradient::LogicalMode)
+            brush.setTransform(brush.transform() * transform);
+
+        // 画笔无法携带变换：按面积缩放比例调整线宽，对均匀缩放与旋转是精确的，对非均匀缩放与斜切是近似的。
+        // non-scaling-stroke(cosmetic)的线宽本就不受变换影响
+        SVGPen &pen {parseResult.pen};
+        if (!pen.isCosmetic())
+            pen.setWidthF(pen.widthF() * std::sqrt(std::abs(transform.determinant())));
+
+        transform.reset();
+    }
+}
+
+void SVGParser::resetBudget()
+{
+    m_usage.elementCount.store(0, std::memory_order_relaxed);
+    m_usage.pathCommandCount.store(0, std::memory_order_relaxed);
+    m_usage.gradientStopCount.store(0, std::memory_order_relaxed);
+    m_usage.memory.store(0, std::memory_order_relaxed);
+    m_usage.error.store(ParseError::NoError, std::memory_order_relaxed);
+
+    // 避免now + maxDuration溢出
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point now {Clock::now()};
+    if (m_limits.maxDuration >= std::chrono::duration_cast<std::chrono::milliseconds>(Clock::time_point::max() - now))
+        m_usage.deadline = Clock::time_point::max();
+    else
+        m_usage.deadline = now + m_limits.maxDuration;
+}
+
+bool SVGParser::budgetExceeded() const
+{
+    if (m_usage.error.load(std::memory_order_relaxed) != ParseError::NoError)
+        return true;
+
+    if (m_usage.deadline != std::chrono::steady_clock::time_point::max() && std::chrono::steady_clock::now() > m_usage.deadline) {
+        fail(ParseError::Timeout);
+        return true;
+    }
+
+    return false;
+}
+
+void SVGParser::fail(ParseError error) const
+{
+    // 只记录最先发生的错误
+    ParseError expected {ParseError::NoError};
+    m_usage.error.compare_exchange_strong(expected, error, std::memory_order_relaxed);
+}
+
+bool SVGParser::consume(std::atomic<qint64> &used, qint64 amount, qint64 limit, ParseError error) const
+{
+    if (budgetExceeded())
+        return false;
+
+    if (used.fetch_add(amount, std::memory_order_relaxed) > limit - amount) {
+        fail(error);
+        return false;
+    }
+
+    return true;
+}
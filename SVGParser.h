@@ -1,6 +1,7 @@
 #pragma once
 
 #include "SVGBrush.h"
+#include "SVGElementType.h"
 #include "SVGPainterPath.h"
 #include "SVGPen.h"
 #include "SVGTransform.h"
@@ -12,6 +13,17 @@
 #include <QObject>
 #include <QSvgRenderer>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <unordered_map>
+
 template<typename GraphicsItem>
 concept SVGStyledGraphicsItem =
         std::derived_from<GraphicsItem, QGraphicsItem> &&
@@ -22,10 +34,27 @@ concept SVGStyledGraphicsItem =
             item->setTransform(transform);
         };
 
+// 可在原处更新的图元，供图元池复用
+template<typename GraphicsItem>
+concept SVGReusableGraphicsItem =
+        SVGStyledGraphicsItem<GraphicsItem> &&
+        requires(const GraphicsItem *item) {
+            { item->pen() } -> std::convertible_to<QPen>;
+            { item->brush() } -> std::convertible_to<QBrush>;
+            { item->path() } -> std::convertible_to<QPainterPath>;
+        };
+
+template<typename Parser>
+class SVGParserOverrides;
+
 class SVGParser : public QObject
 {
     Q_OBJECT
 
+    // 需要检查protected的parseXxx()的签名
+    template<typename Parser>
+    friend class SVGParserOverrides;
+
     using GradientMap = std::unordered_map<QString, std::variant<QLinearGradient, QRadialGradient>>;
 
 public:
@@ -36,30 +65,134 @@ public:
         SVGTransform transform;
     };
 
+    // 流水线解析的各阶段统计，用于调整工作线程数与队列容量
+    struct PipelineStats {
+        qsizetype taskCount {0}; // 分发给工作线程的图形元素数
+        qsizetype peakTaskQueueDepth {0}; // 遍历阶段 -> 工作线程 队列的最大深度
+        qsizetype peakResultQueueDepth {0}; // 工作线程 -> 收集阶段 队列的最大深度
+        qsizetype taskQueueFullWaits {0}; // 遍历阶段因队列满而等待的次数
+        qsizetype resultQueueFullWaits {0}; // 工作线程因队列满而等待的次数
+    };
+
+    // 解析预算，用于处理不可信的输入。超出预算时记录错误，并在下一个检查点停止，默认均不限制。
+    // 计数类预算(元素、路径命令、<stop>)统计的是原始文件，而不是QSvgGenerator规范化后的文档：
+    // loadSVG()在交给QSvgRenderer之前先流式扫描一遍原始文件，超出时不再加载。
+    // QSvgRenderer、QSvgGenerator与DOM树占用的时间和内存只能由maxFileSize与计数类预算间接限制。
+    struct Limits {
+        qint64 maxFileSize {std::numeric_limits<qint64>::max()}; // 文件大小(字节)
+        qint64 maxElementCount {std::numeric_limits<qint64>::max()}; // 原始文件中的元素总数(包括<g>、<stop>等)
+        qint64 maxPathCommandCount {std::numeric_limits<qint64>::max()}; // 原始文件中<path>、<polyline>、<polygon>的命令与数值总数
+        qint64 maxGradientStopCount {std::numeric_limits<qint64>::max()}; // 原始文件中<stop>的总数
+        // 墙钟时间，由loadSVG()与各parse函数分别计时。只在检查点(预先扫描的每个元素、QSvgRenderer::load()、
+        // 渲染到QSvgGenerator与QDomDocument::setContent()各自完成之后、解析的每个元素)检查，
+        // 无法中断这几个Qt调用，因此实际耗时可能超出该值
+        std::chrono::milliseconds maxDuration {std::chrono::milliseconds::max()};
+        // 解析结果(ParseResult与路径结点)占用内存的估计值(字节)，只在parse函数中统计。
+        // 不包括QSvgRenderer的渲染树、QSvgGenerator的输出缓冲与DOM树，它们通常占用更多内存
+        qint64 maxResultMemory {std::numeric_limits<qint64>::max()};
+    };
+
+    enum class ParseError
+    {
+        NoError,
+        FileTooLarge,
+        TooManyElements,
+        TooManyPathCommands,
+        TooManyGradientStops,
+        Timeout,
+        ResultMemoryLimitExceeded,
+        InvalidDocument, // 预先扫描时无法按XML读取，或解析时抛出异常(如引用了不存在的渐变)
+    };
+    Q_ENUM(ParseError)
+
 private:
+    // 本次解析已消耗的预算。parseXxx()为const且可能被多个线程并发调用，因此使用原子计数
+    struct Usage {
+        std::atomic<qint64> elementCount {0};
+        std::atomic<qint64> pathCommandCount {0};
+        std::atomic<qint64> gradientStopCount {0};
+        std::atomic<qint64> memory {0};
+        std::atomic<ParseError> error {ParseError::NoError};
+        std::chrono::steady_clock::time_point deadline {std::chrono::steady_clock::time_point::max()};
+    };
+
     QDomDocument m_doc;
     QSvgRenderer m_renderer;
     GradientMap m_globalGradients;
+    PipelineStats m_pipelineStats;
+    Limits m_limits;
+    mutable Usage m_usage;
 
 public Q_SLOTS:
     bool loadSVG(const QString &fileName);
 
 private:
-    QDomNamedNodeMap parseG(const QDomElement &e, const QDomNamedNodeMap &inheritedAttributes);
+    // 在上层样式的基础上应用<g>自身的属性，得到该层解析后的样式
+    ParseResult parseG(const QDomElement &e, const ParseResult &inheritedStyle) const;
     GradientMap parseGradients(const QDomElement &e) const;
 
+    // 会生成ParseResult的图形元素(<line>与<polygon>已被QSvgGenerator转换为<polyline>与<path>)
+    static bool isParsedElement(SVGElementType type);
+    // 由元素类型分发到对应的parseXxx()。type须满足isParsedElement()
+    ParseResult parseElement(SVGElementType type, const QDomElement &e, const ParseResult &inheritedStyle) const;
+
+    // 是否设置了需要预先扫描原始文件的预算(计数类预算或maxDuration)
+    bool needsSourceScan() const;
+    // 流式扫描原始文件并消耗计数类预算。超出预算或文件不是有效的XML时返回false
+    bool scanSourceBudget(const QString &fileName);
+
+    bool consume(std::atomic<qint64> &used, qint64 amount, qint64 limit, ParseError error) const;
+
 protected:
     // 获取<svg>结点
     QDomElement SVGNode() const { return m_doc.documentElement(); }
 
+    // 解析<defs>后遍历所有图形元素，对每个元素调用visitor(type, element, inheritedStyle)
+    template<typename Visitor>
+    void traverse(Visitor &&visitor);
+
+    // parse()的公共部分：重置预算、遍历、处理异常与错误。
+    // 对满足isParsedElement()的元素调用elementParser(type, element, inheritedStyle)得到ParseResult
+    template<typename ElementParser>
+    std::vector<ParseResult> parseWith(ElementParser &&elementParser);
+
+    // 清零已消耗的预算并重新开始计时。每次解析开始时调用
+    void resetBudget();
+
+    // 是否已超出预算(包括墙钟时间)。在循环中定期检查，超出时应立即停止
+    bool budgetExceeded() const;
+
+    // 记录错误，只保留最先发生的一个
+    void fail(ParseError error) const;
+
+    // 消耗预算。超出预算时记录错误并返回false，调用者应立即停止当前工作
+    bool consumeElements(qint64 count) const { return consume(m_usage.elementCount, count, m_limits.maxElementCount, ParseError::TooManyElements); }
+    bool consumePathCommands(qint64 count) const { return consume(m_usage.pathCommandCount, count, m_limits.maxPathCommandCount, ParseError::TooManyPathCommands); }
+    bool consumeGradientStops(qint64 count) const { return consume(m_usage.gradientStopCount, count, m_limits.maxGradientStopCount, ParseError::TooManyGradientStops); }
+    bool consumeMemory(qint64 bytes) const { return consume(m_usage.memory, bytes, m_limits.maxResultMemory, ParseError::ResultMemoryLimitExceeded); }
+
+    // 由解析结果创建图元
+    template<SVGStyledGraphicsItem GraphicsItem>
+    static std::vector<GraphicsItem *> createItems(std::vector<ParseResult> &parseResults, QGraphicsScene *scene);
+
+    // 图元内容(pen、brush、path)的哈希值，用于在重新加载时匹配未变化的图元
+    static std::size_t contentKey(const QPen &pen, const QBrush &brush, const QPainterPath &path);
+
+    // 以解析结果更新图元池
+    template<SVGReusableGraphicsItem GraphicsItem>
+    static void updateItems(std::vector<ParseResult> &parseResults, std::vector<GraphicsItem *> &items, QGraphicsScene *scene);
+
     // 解析各结点
-    virtual ParseResult parseRect(const QDomElement &e, const QDomNamedNodeMap &inheritedAttributes) const;
-    virtual ParseResult parseEllipse(const QDomElement &e, const QDomNamedNodeMap &inheritedAttributes) const;
-    virtual ParseResult parseCircle(const QDomElement &e, const QDomNamedNodeMap &inheritedAttributes) const;
-    virtual ParseResult parsePolyline(const QDomElement &e, const QDomNamedNodeMap &inheritedAttributes) const;
+    // parseConcurrently()在多个工作线程中同时调用parseRect()等图形元素的解析函数，因此override必须是线程安全的：
+    // 只读访问e、inheritedStyle与成员，不修改共享状态(需要时自行加锁或使用原子变量)。
+    // parseLinearGradient()与parseRadialGradient()只在遍历线程中调用
+    virtual ParseResult parseRect(const QDomElement &e, const ParseResult &inheritedStyle) const;
+    virtual ParseResult parseEllipse(const QDomElement &e, const ParseResult &inheritedStyle) const;
+    virtual ParseResult parseCircle(const QDomElement &e, const ParseResult &inheritedStyle) const;
+    virtual ParseResult parsePolyline(const QDomElement &e, const ParseResult &inheritedStyle) const;
     // <line>被QSvgGenerator视为<polyline>的一种
     // <polygon>被QSvgGenerator视为<path>的一种
-    virtual ParseResult parsePath(const QDomElement &e, const QDomNamedNodeMap &inheritedAttributes) const;
+    virtual ParseResult parsePath(const QDomElement &e, const ParseResult &inheritedStyle) const;
     virtual QLinearGradient parseLinearGradient(const QDomElement &e) const;
     virtual QRadialGradient parseRadialGradient(const QDomElement &e) const;
 
@@ -73,24 +206,128 @@ public:
 
     QSize size() const { return m_renderer.defaultSize(); }
 
+    void setLimits(const Limits &limits) { m_limits = limits; }
+
+    const Limits &limits() const { return m_limits; }
+
+    // 最近一次loadSVG()或解析的错误。出错时loadSVG()返回false，各parse函数返回空结果
+    ParseError error() const { return m_usage.error.load(std::memory_order_relaxed); }
+
     [[nodiscard]] std::vector<ParseResult> parse();
 
+    // 流水线解析：遍历线程解析样式并分发元素，workerCount个工作线程并发构建ParseResult，
+    // 调用线程按完成顺序收集结果(每得到一个结果即调用onResult)，各阶段之间以有界无锁队列连接，队列满/空时阻塞等待。
+    // 返回值与parse()相同(按文档顺序)。workerCount <= 0时使用QThread::idealThreadCount()，queueCapacity至少为1。
+    // 各阶段抛出的异常记录为ParseError::InvalidDocument；onResult抛出的异常不记录为解析错误，
+    // 其余阶段随即取消，在所有线程结束后重新抛出。
+    // 图形元素的parseXxx()会被并发调用，见其说明。
+    [[nodiscard]] std::vector<ParseResult> parseConcurrently(int workerCount = 0, qsizetype queueCapacity = 256,
+                                                             const std::function<void(const ParseResult &)> &onResult = {});
+
+    // 最近一次parseConcurrently()的统计
+    PipelineStats pipelineStats() const { return m_pipelineStats; }
+
+    // 将每个解析结果的transform烘焙进其painterPath，烘焙后transform被重置为单位变换。
+    // userSpaceOnUse的渐变随之变换；objectBoundingBox的渐变取变换后路径的包围盒，旋转或斜切时与原图不同。
+    // 线宽按变换的面积缩放比例调整，非均匀缩放或斜切下的描边只是近似(QPen无法表示各向不同的线宽)
+    static void bakeTransforms(std::vector<ParseResult> &parseResults);
+
     template<SVGStyledGraphicsItem GraphicsItem>
     std::vector<GraphicsItem *> parse(QGraphicsScene *scene = nullptr);
+
+    // 以items为图元池重新解析，适合反复重新加载同一SVG的场景：
+    // 先按内容(pen、brush、path的哈希)匹配，内容未变的图元原样复用；其余结果按文档顺序复用图元，
+    // 只更新发生变化的属性；多出的图元被删除，不足时新建。重新加载的开销因此与实际变化的元素数相当。
+    // QSvgGenerator规范化后的文档不保留元素id，因此无法按id匹配。返回后items按文档顺序排列，堆叠次序与之一致。
+    template<SVGReusableGraphicsItem GraphicsItem>
+    void parse(std::vector<GraphicsItem *> &items, QGraphicsScene *scene = nullptr);
 };
 
+template<typename Visitor>
+void SVGParser::traverse(Visitor &&visitor)
+{
+    QDomElement SVGNode {this->SVGNode()};
+
+    // 解析<defs>元素结点
+    QDomElement defsNode {SVGNode.firstChildElement("defs")};
+    if (!defsNode.isNull())
+        m_globalGradients = parseGradients(defsNode);
+    else
+        m_globalGradients.clear();
+
+    // 开始解析图形元素
+    // 以显式栈代替递归做深度优先遍历，可处理任意嵌套深度、每个<g>下任意数量的子元素。
+    // 每层只保存该层解析后的样式和下一个待访问的子元素，内存占用与嵌套深度成正比。
+    struct Frame {
+        QDomElement next;
+        ParseResult style;
+    };
+
+    std::vector<Frame> stack;
+    stack.push_back({SVGNode.firstChildElement(), parseG(SVGNode, ParseResult {})});
+
+    while (!stack.empty()) {
+        Frame &frame {stack.back()};
+        if (frame.next.isNull()) {
+            stack.pop_back();
+            continue;
+        }
+
+        // 超出预算时立即停止遍历
+        if (!consumeMemory(sizeof(ParseResult)))
+            return;
+
+        QDomElement e {frame.next};
+        frame.next = e.nextSiblingElement();
+
+        SVGElementType type {svgElementType(e.tagName())};
+        if (type == SVGElementType::G) {
+            ParseResult style {parseG(e, frame.style)};
+            stack.push_back({e.firstChildElement(), std::move(style)}); // 此后frame失效
+        } else
+            visitor(type, e, frame.style);
+    }
+}
+
+template<typename ElementParser>
+std::vector<SVGParser::ParseResult> SVGParser::parseWith(ElementParser &&elementParser)
+{
+    std::vector<ParseResult> parseResults;
+    resetBudget();
+
+    // 无效的文档(如引用了不存在的渐变)可能导致解析时抛出异常，记录为错误
+    try {
+        traverse([&](SVGElementType type, const QDomElement &e, const ParseResult &inheritedStyle) {
+            if (isParsedElement(type))
+                parseResults.push_back(elementParser(type, e, inheritedStyle));
+        });
+    } catch (const std::exception &exception) {
+        fail(ParseError::InvalidDocument);
+        qWarning() << "Exception while parsing SVG:" << exception.what();
+    }
+
+    if (error() != ParseError::NoError) {
+        qWarning() << "Parsing aborted:" << error();
+        return {};
+    }
+
+    return parseResults;
+}
+
 template<SVGStyledGraphicsItem GraphicsItem>
-std::vector<GraphicsItem *> SVGParser::parse(QGraphicsScene *scene)
+std::vector<GraphicsItem *> SVGParser::createItems(std::vector<ParseResult> &parseResults, QGraphicsScene *scene)
 {
-    std::vector<ParseResult> parseResults {parse()};
+    bakeTransforms(parseResults);
+
     std::vector<GraphicsItem *> items;
+    items.reserve(parseResults.size());
 
     for (const auto &parseResult: parseResults) {
         GraphicsItem *item {new GraphicsItem};
 
         item->setPen(parseResult.pen);
         item->setBrush(parseResult.brush);
-        item->setPath(parseResult.transform.map(parseResult.painterPath));
+        item->setPath(parseResult.painterPath);
 
         items.push_back(item);
 
@@ -100,3 +337,239 @@ std::vector<GraphicsItem *> SVGParser::parse(QGraphicsScene *scene)
 
     return items;
 }
+
+template<SVGReusableGraphicsItem GraphicsItem>
+void SVGParser::updateItems(std::vector<ParseResult> &parseResults, std::vector<GraphicsItem *> &items, QGraphicsScene *scene)
+{
+    bakeTransforms(parseResults);
+
+    constexpr std::size_t unmatched {std::numeric_limits<std::size_t>::max()};
+    std::vector<GraphicsItem *> matchedItems(parseResults.size(), nullptr);
+    std::vector<std::size_t> oldIndices(parseResults.size(), unmatched); // 复用的图元在原图元池中的位置
+    std::vector<bool> reused(items.size(), false);
+
+    // 1. 按内容匹配：pen、brush、path均未变化的图元原样复用，不调用任何setter。
+    //    插入或删除元素后，其余元素即使位置改变也能找到原来的图元。
+    //    内容键相同时再比较pen与brush(开销很小)；path不逐结点比较，只依赖64位哈希
+    std::unordered_map<std::size_t, std::vector<std::size_t>> itemsByKey; // 内容键 -> 原图元池中的位置(逆序，便于从尾部取出)
+    itemsByKey.reserve(items.size());
+    for (std::size_t j {items.size()}; j-- > 0;)
+        itemsByKey[contentKey(items[j]->pen(), items[j]->brush(), items[j]->path())].push_back(j);
+
+    for (std::size_t i {0}; i < parseResults.size(); ++i) {
+        const ParseResult &parseResult {parseResults[i]};
+        auto found {itemsByKey.find(contentKey(parseResult.pen, parseResult.brush, parseResult.painterPath))};
+        if (found == itemsByKey.end())
+            continue;
+
+        std::vector<std::size_t> &candidates {found->second};
+        auto candidate {std::find_if(candidates.rbegin(), candidates.rend(), [&](std::size_t j) {
+            return items[j]->pen() == parseResult.pen && items[j]->brush() == parseResult.brush;
+        })};
+        if (candidate == candidates.rend())
+            continue; // 哈希冲突，交给第2步按位置复用并更新
+
+        const std::size_t j {*candidate};
+        candidates.erase(std::next(candidate).base());
+        matchedItems[i] = items[j];
+        oldIndices[i] = j;
+        reused[j] = true;
+    }
+
+    // 2. 其余结果按位置复用图元，只更新发生变化的属性；位置上的图元已被占用时取任一未复用的图元
+    std::size_t spare {0}; // 下一个可能未复用的图元
+    auto update {[&](std::size_t i, std::size_t j) {
+        const ParseResult &parseResult {parseResults[i]};
+        GraphicsItem *item {items[j]};
+
+        if (item->pen() != parseResult.pen)
+            item->setPen(parseResult.pen);
+        if (item->brush() != parseResult.brush)
+            item->setBrush(parseResult.brush);
+        if (item->path() != parseResult.painterPath)
+            item->setPath(parseResult.painterPath);
+
+        matchedItems[i] = item;
+        oldIndices[i] = j;
+        reused[j] = true;
+    }};
+
+    for (std::size_t i {0}; i < parseResults.size(); ++i) {
+        if (matchedItems[i]) continue;
+
+        if (i < items.size() && !reused[i]) {
+            update(i, i);
+            continue;
+        }
+
+        while (spare < items.size() && reused[spare])
+            ++spare;
+        if (spare < items.size()) {
+            update(i, spare);
+            continue;
+        }
+
+        // 图元不足时新建
+        const ParseResult &parseResult {parseResults[i]};
+        GraphicsItem *item {new GraphicsItem};
+
+        item->setPen(parseResult.pen);
+        item->setBrush(parseResult.brush);
+        item->setPath(parseResult.painterPath);
+
+        matchedItems[i] = item;
+    }
+
+    // 删除未复用的图元(QGraphicsItem析构时会将自身从场景中移除)
+    for (std::size_t j {0}; j < items.size(); ++j) {
+        if (!reused[j])
+            delete items[j];
+    }
+
+    // 3. 同一场景中的图元按加入顺序堆叠。复用的图元顺序可能已改变，新建的图元会位于最上层，
+    //    因此从后往前检查相邻图元的先后，只对顺序不对的图元调用stackBefore()。
+    //    stackBefore()只对同一场景中父图元相同的图元有效(否则Qt会警告"cannot stack under")，
+    //    图元不在场景中或父图元不同时不调整堆叠顺序
+    items = std::move(matchedItems);
+    std::vector<double> ranks(items.size()); // 图元当前的堆叠次序，只用于比较先后
+    double nextNewRank {static_cast<double>(reused.size())};
+    for (std::size_t i {0}; i < items.size(); ++i) {
+        GraphicsItem *item {items[i]};
+        if (scene && item->scene() != scene) {
+            scene->addItem(item); // 新加入场景的图元位于最上层
+            ranks[i] = nextNewRank++;
+        } else
+            ranks[i] = oldIndices[i] == unmatched ? nextNewRank++ : static_cast<double>(oldIndices[i]);
+    }
+
+    const bool stackable {!items.empty() && items.front()->scene()
+        && std::all_of(items.begin(), items.end(), [&](const GraphicsItem *item) {
+            return item->scene() == items.front()->scene() && item->parentItem() == items.front()->parentItem();
+        })};
+    if (!stackable)
+        return;
+
+    for (std::size_t i {items.size()}; i-- > 1;) {
+        // items[i - 1]应位于items[i]之下
+        if (ranks[i - 1] < ranks[i]) continue;
+
+        items[i - 1]->stackBefore(items[i]);
+        ranks[i - 1] = std::nextafter(ranks[i], -std::numeric_limits<double>::infinity()); // 紧挨在items[i]之下
+    }
+}
+
+template<SVGStyledGraphicsItem GraphicsItem>
+std::vector<GraphicsItem *> SVGParser::parse(QGraphicsScene *scene)
+{
+    std::vector<ParseResult> parseResults {parse()};
+    return createItems<GraphicsItem>(parseResults, scene);
+}
+
+template<SVGReusableGraphicsItem GraphicsItem>
+void SVGParser::parse(std::vector<GraphicsItem *> &items, QGraphicsScene *scene)
+{
+    std::vector<ParseResult> parseResults {parse()};
+    if (error() != ParseError::NoError)
+        return; // 解析失败时保留图元池原样
+
+    updateItems(parseResults, items, scene);
+}
+
+// 检查Parser中各图形元素的parseXxx()：要么继承自SVGParser，要么以完全相同的签名重新声明。
+// 签名写错(参数、const或返回值不同)或有重载时检查失败，而不是静默地调用基类的实现。
+// 作为SVGParser的友元访问其protected成员；若Parser将parseXxx()声明为protected或private，需将本类声明为友元
+template<typename Parser>
+class SVGParserOverrides
+{
+    using ParseResult = SVGParser::ParseResult;
+
+    template<typename Class>
+    using ElementParser = ParseResult (Class::*)(const QDomElement &, const ParseResult &) const;
+
+    template<typename Member>
+    static constexpr bool isElementParser {std::is_same_v<Member, ElementParser<SVGParser>> ||
+                                           std::is_same_v<Member, ElementParser<Parser>>};
+
+public:
+    static constexpr bool valid {requires {
+        requires isElementParser<decltype(&Parser::parseRect)>;
+        requires isElementParser<decltype(&Parser::parseEllipse)>;
+        requires isElementParser<decltype(&Parser::parseCircle)>;
+        requires isElementParser<decltype(&Parser::parsePolyline)>;
+        requires isElementParser<decltype(&Parser::parsePath)>;
+    }};
+};
+
+// 静态分发要求派生类为final：编译期即可确定各parseXxx()的最终实现，逐元素的调用得以内联
+template<typename Parser>
+concept SVGFinalParser = std::derived_from<Parser, SVGParser> && std::is_final_v<Parser> &&
+                         SVGParserOverrides<Parser>::valid;
+
+// SVGParser的静态多态版本。用法：class MyParser final : public SVGStaticParser<MyParser> {...};
+// 派生类中隐藏(而非override)的parseXxx()同样生效，但签名须与SVGParser中的完全相同(见SVGParserOverrides)。
+// 若将其声明为protected，需将SVGStaticParser<MyParser>与SVGParserOverrides<MyParser>声明为友元。
+// 需要在运行期替换实现时，请直接继承SVGParser并override虚函数。
+template<typename Derived>
+class SVGStaticParser : public SVGParser
+{
+    Derived &derived() { return static_cast<Derived &>(*this); }
+
+public:
+    [[nodiscard]] std::vector<ParseResult> parse()
+        requires SVGFinalParser<Derived>;
+
+    template<SVGStyledGraphicsItem GraphicsItem>
+    std::vector<GraphicsItem *> parse(QGraphicsScene *scene = nullptr)
+        requires SVGFinalParser<Derived>;
+
+    template<SVGReusableGraphicsItem GraphicsItem>
+    void parse(std::vector<GraphicsItem *> &items, QGraphicsScene *scene = nullptr)
+        requires SVGFinalParser<Derived>;
+};
+
+template<typename Derived>
+std::vector<SVGParser::ParseResult> SVGStaticParser<Derived>::parse()
+    requires SVGFinalParser<Derived>
+{
+    Derived &self {derived()};
+
+    return parseWith([&](SVGElementType type, const QDomElement &e, const ParseResult &inheritedStyle) {
+        // 限定名调用不经过虚函数表
+        switch (type) {
+        case SVGElementType::Rect:
+            return self.Derived::parseRect(e, inheritedStyle);
+        case SVGElementType::Ellipse:
+            return self.Derived::parseEllipse(e, inheritedStyle);
+        case SVGElementType::Circle:
+            return self.Derived::parseCircle(e, inheritedStyle);
+        case SVGElementType::Polyline:
+            return self.Derived::parsePolyline(e, inheritedStyle);
+        case SVGElementType::Path:
+            return self.Derived::parsePath(e, inheritedStyle);
+        default:
+            assert(false);
+            return ParseResult {};
+        }
+    });
+}
+
+template<typename Derived>
+template<SVGStyledGraphicsItem GraphicsItem>
+std::vector<GraphicsItem *> SVGStaticParser<Derived>::parse(QGraphicsScene *scene)
+    requires SVGFinalParser<Derived>
+{
+    std::vector<ParseResult> parseResults {parse()};
+    return createItems<GraphicsItem>(parseResults, scene);
+}
+
+template<typename Derived>
+template<SVGReusableGraphicsItem GraphicsItem>
+void SVGStaticParser<Derived>::parse(std::vector<GraphicsItem *> &items, QGraphicsScene *scene)
+    requires SVGFinalParser<Derived>
+{
+    std::vector<ParseResult> parseResults {parse()};
+    if (error() != ParseError::NoError)
+        return; // 解析失败时保留图元池原样
+
+    updateItems(parseResults, items, scene);
+}
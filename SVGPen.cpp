@@ -7,8 +7,11 @@ void SVGPen::parseStroke(const QString &stroke)
     else if (stroke == "none")
         setStyle(Qt::NoPen);
     else {
+        // 保留已继承的stroke-opacity
+        QColor color {QColor::fromString(stroke)};
+        color.setAlphaF(QPen::color().alphaF());
         setStyle(Qt::SolidLine);
-        setColor(QColor::fromString(stroke));
+        setColor(color);
     }
 }
 
@@ -0,0 +1,571 @@
+#include "SVGScanner.h"
+
+#include <QColor>
+#include <QDebug>
+#include <QFile>
+#include <QTransform>
+#include <QXmlStreamReader>
+#include <QtMath>
+
+#include <algorithm>
+#include <cmath>
+
+// 按SVG数值语法从字符串中依次读取数值、标志位与路径命令，不产生临时字符串
+// reference: https://www.w3.org/TR/SVGTiny12/paths.html#PathDataBNF
+class SVGNumberReader
+{
+    QStringView m_text;
+    qsizetype m_pos {0};
+
+    static bool isDigit(QChar c) { return c.unicode() >= '0' && c.unicode() <= '9'; }
+
+    void skipSeparators()
+    {
+        while (m_pos < m_text.size() && (m_text[m_pos].isSpace() || m_text[m_pos] == ','))
+            ++m_pos;
+    }
+
+public:
+    explicit SVGNumberReader(QStringView text)
+            : m_text {text} {}
+
+    bool atEnd()
+    {
+        skipSeparators();
+        return m_pos >= m_text.size();
+    }
+
+    bool readCommand(QChar &command)
+    {
+        skipSeparators();
+        if (m_pos >= m_text.size() || !m_text[m_pos].isLetter())
+            return false;
+        command = m_text[m_pos++];
+        return true;
+    }
+
+    bool readNumber(qreal &value)
+    {
+        skipSeparators();
+        qsizetype start {m_pos};
+
+        if (m_pos < m_text.size() && (m_text[m_pos] == '+' || m_text[m_pos] == '-'))
+            ++m_pos;
+
+        bool hasDigits {false};
+        bool hasDot {false};
+        while (m_pos < m_text.size()) {
+            QChar c {m_text[m_pos]};
+            if (isDigit(c))
+                hasDigits = true;
+            else if (c == '.' && !hasDot) // 形如"0.5.5"时第二个'.'开始下一个数
+                hasDot = true;
+            else
+                break;
+            ++m_pos;
+        }
+
+        if (!hasDigits) {
+            m_pos = start;
+            return false;
+        }
+
+        // 指数部分。'e'后没有数字时不属于该数
+        if (m_pos < m_text.size() && (m_text[m_pos] == 'e' || m_text[m_pos] == 'E')) {
+            qsizetype exponentStart {m_pos++};
+            if (m_pos < m_text.size() && (m_text[m_pos] == '+' || m_text[m_pos] == '-'))
+                ++m_pos;
+            if (m_pos < m_text.size() && isDigit(m_text[m_pos])) {
+                while (m_pos < m_text.size() && isDigit(m_text[m_pos]))
+                    ++m_pos;
+            } else
+                m_pos = exponentStart;
+        }
+
+        bool ok;
+        value = m_text.sliced(start, m_pos - start).toDouble(&ok);
+        return ok;
+    }
+
+    bool readPoint(QPointF &point)
+    {
+        qreal x, y;
+        if (!readNumber(x) || !readNumber(y))
+            return false;
+        point = QPointF {x, y};
+        return true;
+    }
+
+    // 圆弧的large-arc-flag与sweep-flag只有一个字符，可与后续数值紧挨在一起
+    bool readFlag(bool &flag)
+    {
+        skipSeparators();
+        if (m_pos >= m_text.size() || (m_text[m_pos] != '0' && m_text[m_pos] != '1'))
+            return false;
+        flag = m_text[m_pos++] == '1';
+        return true;
+    }
+};
+
+// 累积点集的包围盒
+class SVGBoundsAccumulator
+{
+    qreal m_left {0};
+    qreal m_top {0};
+    qreal m_right {0};
+    qreal m_bottom {0};
+    bool m_empty {true};
+
+public:
+    void add(const QPointF &point)
+    {
+        if (m_empty) {
+            m_left = m_right = point.x();
+            m_top = m_bottom = point.y();
+            m_empty = false;
+            return;
+        }
+        m_left = std::min(m_left, point.x());
+        m_right = std::max(m_right, point.x());
+        m_top = std::min(m_top, point.y());
+        m_bottom = std::max(m_bottom, point.y());
+    }
+
+    void add(const QRectF &rect)
+    {
+        add(rect.topLeft());
+        add(rect.bottomRight());
+    }
+
+    QRectF bounds() const { return m_empty ? QRectF {} : QRectF {QPointF {m_left, m_top}, QPointF {m_right, m_bottom}}; }
+};
+
+void SVGScanner::clear()
+{
+    m_viewBox = QRectF {};
+    m_elements.clear();
+    m_elementCounts.fill(0);
+    m_colors.clear();
+    m_gradients.clear();
+    m_transforms.clear();
+}
+
+void SVGScanner::scanViewBox(QStringView viewBox, QStringView width, QStringView height)
+{
+    SVGNumberReader reader {viewBox};
+    qreal x, y, w, h;
+    if (reader.readNumber(x) && reader.readNumber(y) && reader.readNumber(w) && reader.readNumber(h)) {
+        m_viewBox = QRectF {x, y, w, h};
+        return;
+    }
+
+    // 未指定viewBox时以width和height代替。忽略长度单位
+    qreal widthValue {0};
+    qreal heightValue {0};
+    SVGNumberReader {width}.readNumber(widthValue);
+    SVGNumberReader {height}.readNumber(heightValue);
+    m_viewBox = QRectF {0, 0, widthValue, heightValue};
+}
+
+void SVGScanner::scanPaint(QStringView paint)
+{
+    paint = paint.trimmed();
+    if (paint.isEmpty() || paint == u"none" || paint == u"currentColor" || paint == u"inherit")
+        return;
+
+    if (paint.startsWith(u"url(")) {
+        // 取得id
+        qsizetype begin {paint.indexOf('#') + 1};
+        qsizetype end {paint.indexOf(')')};
+        if (begin > 0 && end > begin)
+            m_gradients.insert(paint.sliced(begin, end - begin).toString());
+        return;
+    }
+
+    QColor color;
+    if (!parseRgb(paint, color))
+        color = QColor::fromString(paint);
+    if (color.isValid())
+        m_colors.insert(color.rgba());
+}
+
+void SVGScanner::scanStyle(QStringView style)
+{
+    // 形如"fill:#fff; stroke:red"
+    for (QStringView declaration: style.tokenize(u';', Qt::SkipEmptyParts)) {
+        qsizetype colon {declaration.indexOf(':')};
+        if (colon < 0) continue;
+
+        QStringView name {declaration.first(colon).trimmed()};
+        if (name == u"fill" || name == u"stroke" || name == u"stop-color")
+            scanPaint(declaration.sliced(colon + 1));
+    }
+}
+
+bool SVGScanner::parseRgb(QStringView paint, QColor &color)
+{
+    // 形如"rgb(255,0,0)"或"rgb(100%,0%,0%)"，QColor::fromString()不支持这两种形式
+    // reference: https://www.w3.org/TR/SVGTiny12/painting.html#colorSyntax
+    if (!paint.startsWith(u"rgb(") || !paint.endsWith(')'))
+        return false;
+
+    const QList<QStringView> components {paint.sliced(4, paint.size() - 5).split(',')};
+    if (components.size() != 3)
+        return false;
+
+    int rgb[3];
+    for (qsizetype i {0}; i < 3; ++i) {
+        QStringView component {components[i].trimmed()};
+        const bool percentage {component.endsWith('%')};
+        if (percentage)
+            component.chop(1);
+
+        bool ok;
+        qreal value {component.toDouble(&ok)};
+        if (!ok)
+            return false;
+        if (percentage)
+            value = value * 255 / 100;
+
+        // 超出范围的值截断到[0, 255]
+        rgb[i] = static_cast<int>(std::lround(std::clamp(value, qreal {0}, qreal {255})));
+    }
+
+    color = QColor {rgb[0], rgb[1], rgb[2]};
+    return true;
+}
+
+QRectF SVGScanner::arcBounds(const QPointF &startPt, const QPointF &endPt, qreal rx, qreal ry, qreal xAxisRotation,
+                             bool largeArc, bool sweep)
+{
+    // reference: https://www.w3.org/TR/SVG11/implnote.html#ArcImplementationNotes
+    // 按F.6.5与F.6.6求出(必要时放大半径后的)椭圆中心，取整个椭圆的包围盒。圆弧是椭圆的一部分，因此结果是保守的
+
+    const QRectF endpoints {QRectF {startPt, endPt}.normalized()};
+
+    // F.6.2：端点重合时忽略该段，半径为0时视为直线
+    if (startPt == endPt)
+        return endpoints;
+    rx = std::abs(rx);
+    ry = std::abs(ry);
+    if (rx == 0 || ry == 0)
+        return endpoints;
+
+    const qreal phi {qDegreesToRadians(xAxisRotation)};
+    const qreal cosPhi {std::cos(phi)};
+    const qreal sinPhi {std::sin(phi)};
+
+    // F.6.5 step 1：旋转后的半弦
+    const QPointF halfChord {(startPt - endPt) / 2};
+    const qreal x1 {cosPhi * halfChord.x() + sinPhi * halfChord.y()};
+    const qreal y1 {-sinPhi * halfChord.x() + cosPhi * halfChord.y()};
+
+    // F.6.6：半径不足以连接两端点时按sqrt(Λ)放大
+    const qreal lambda {(x1 * x1) / (rx * rx) + (y1 * y1) / (ry * ry)};
+    if (lambda > 1) {
+        const qreal scale {std::sqrt(lambda)};
+        rx *= scale;
+        ry *= scale;
+    }
+
+    // F.6.5 step 2、3：椭圆中心
+    const qreal numerator {rx * rx * ry * ry - rx * rx * y1 * y1 - ry * ry * x1 * x1};
+    const qreal denominator {rx * rx * y1 * y1 + ry * ry * x1 * x1};
+    qreal coefficient {std::sqrt(std::max(numerator / denominator, qreal {0}))};
+    if (largeArc == sweep)
+        coefficient = -coefficient;
+    const qreal cx1 {coefficient * rx * y1 / ry};
+    const qreal cy1 {-coefficient * ry * x1 / rx};
+    const QPointF center {cosPhi * cx1 - sinPhi * cy1 + (startPt.x() + endPt.x()) / 2,
+                          sinPhi * cx1 + cosPhi * cy1 + (startPt.y() + endPt.y()) / 2};
+
+    // 旋转后椭圆的包围盒半宽与半高
+    const qreal halfWidth {std::hypot(rx * cosPhi, ry * sinPhi)};
+    const qreal halfHeight {std::hypot(rx * sinPhi, ry * cosPhi)};
+    const QRectF ellipse {center.x() - halfWidth, center.y() - halfHeight, 2 * halfWidth, 2 * halfHeight};
+
+    // 端点也计入，避免舍入误差使端点落在包围盒之外
+    return ellipse.united(endpoints);
+}
+
+QTransform SVGScanner::parseTransform(QStringView transform)
+{
+    // 形如"translate(10,20) rotate(45 5 5)"，各变换依次从左到右作用于坐标系(点上先应用最右边的变换)。
+    // 遇到语法错误时停止，返回此前已读取部分的变换
+    // reference: https://www.w3.org/TR/SVGTiny12/coords.html#TransformAttribute
+    QTransform result;
+
+    while (!transform.isEmpty()) {
+        const qsizetype open {transform.indexOf('(')};
+        const qsizetype close {transform.indexOf(')')};
+        if (open < 0 || close < open)
+            break;
+
+        // 变换名前可以有空白与逗号
+        QStringView name {transform.first(open).trimmed()};
+        while (name.startsWith(',')) name = name.sliced(1).trimmed();
+
+        SVGNumberReader reader {transform.sliced(open + 1, close - open - 1)};
+        qreal values[6];
+        int count {0};
+        while (count < 6 && reader.readNumber(values[count]))
+            ++count;
+        transform = transform.sliced(close + 1);
+
+        if (name == u"matrix" && count == 6)
+            result = QTransform {values[0], values[1], values[2], values[3], values[4], values[5]} * result;
+        else if (name == u"translate" && count >= 1)
+            result.translate(values[0], count >= 2 ? values[1] : 0);
+        else if (name == u"scale" && count >= 1)
+            result.scale(values[0], count >= 2 ? values[1] : values[0]);
+        else if (name == u"rotate" && count == 1)
+            result.rotate(values[0]);
+        else if (name == u"rotate" && count == 3)
+            result.translate(values[1], values[2]).rotate(values[0]).translate(-values[1], -values[2]);
+        else if (name == u"skewX" && count == 1)
+            result.shear(std::tan(qDegreesToRadians(values[0])), 0);
+        else if (name == u"skewY" && count == 1)
+            result.shear(0, std::tan(qDegreesToRadians(values[0])));
+        else
+            break;
+    }
+
+    return result;
+}
+
+QRectF SVGScanner::pointsBounds(QStringView points)
+{
+    // reference: https://www.w3.org/TR/SVGTiny12/shapes.html#PolylineElement
+    SVGNumberReader reader {points};
+    SVGBoundsAccumulator accumulator;
+
+    QPointF point;
+    while (reader.readPoint(point))
+        accumulator.add(point);
+
+    return accumulator.bounds();
+}
+
+QRectF SVGScanner::pathBounds(QStringView d)
+{
+    // reference: https://www.w3.org/TR/SVGTiny12/paths.html
+    // 曲线取其控制点的包围盒(与QPainterPath::controlPointRect()一致)，圆弧取包含整段圆弧的保守范围。
+    // 遇到语法错误时停止，返回此前已读取部分的包围盒。
+    SVGNumberReader reader {d};
+    SVGBoundsAccumulator accumulator;
+
+    QChar command;
+    QPointF current;
+    QPointF subpathStart;
+    QPointF lastCtrlPt; // 用于S与T。上一段不是曲线时与当前点相同，此时对称点即当前点
+
+    while (!reader.atEnd()) {
+        if (!reader.readCommand(command) && (command.isNull() || command == 'Z' || command == 'z'))
+            break; // 数值前没有命令，或Z之后跟了数值
+
+        const bool relative {command.isLower()};
+        const QPointF origin {relative ? current : QPointF {}};
+        bool ok {true};
+
+        switch (command.toUpper().unicode()) {
+        case 'M': {
+            QPointF point;
+            ok = reader.readPoint(point);
+            if (!ok) break;
+            current = subpathStart = lastCtrlPt = origin + point;
+            accumulator.add(current);
+            command = relative ? QChar {'l'} : QChar {'L'}; // M之后重复的坐标视为L
+            break;
+        }
+        case 'L': {
+            QPointF point;
+            ok = reader.readPoint(point);
+            if (!ok) break;
+            current = lastCtrlPt = origin + point;
+            accumulator.add(current);
+            break;
+        }
+        case 'T': {
+            // 控制点为上一段控制点关于当前点的对称点
+            QPointF point;
+            ok = reader.readPoint(point);
+            if (!ok) break;
+            lastCtrlPt = 2 * current - lastCtrlPt;
+            accumulator.add(lastCtrlPt);
+            current = origin + point;
+            accumulator.add(current);
+            break;
+        }
+        case 'H': {
+            qreal x;
+            ok = reader.readNumber(x);
+            if (!ok) break;
+            current.setX(origin.x() + x);
+            lastCtrlPt = current;
+            accumulator.add(current);
+            break;
+        }
+        case 'V': {
+            qreal y;
+            ok = reader.readNumber(y);
+            if (!ok) break;
+            current.setY(origin.y() + y);
+            lastCtrlPt = current;
+            accumulator.add(current);
+            break;
+        }
+        case 'C': {
+            QPointF ctrlPt1, ctrlPt2, endPt;
+            ok = reader.readPoint(ctrlPt1) && reader.readPoint(ctrlPt2) && reader.readPoint(endPt);
+            if (!ok) break;
+            accumulator.add(origin + ctrlPt1);
+            lastCtrlPt = origin + ctrlPt2;
+            accumulator.add(lastCtrlPt);
+            current = origin + endPt;
+            accumulator.add(current);
+            break;
+        }
+        case 'S': {
+            // 第一个控制点为上一段控制点关于当前点的对称点
+            QPointF ctrlPt2, endPt;
+            ok = reader.readPoint(ctrlPt2) && reader.readPoint(endPt);
+            if (!ok) break;
+            accumulator.add(2 * current - lastCtrlPt);
+            lastCtrlPt = origin + ctrlPt2;
+            accumulator.add(lastCtrlPt);
+            current = origin + endPt;
+            accumulator.add(current);
+            break;
+        }
+        case 'Q': {
+            QPointF ctrlPt, endPt;
+            ok = reader.readPoint(ctrlPt) && reader.readPoint(endPt);
+            if (!ok) break;
+            lastCtrlPt = origin + ctrlPt;
+            accumulator.add(lastCtrlPt);
+            current = origin + endPt;
+            accumulator.add(current);
+            break;
+        }
+        case 'A': {
+            qreal rx, ry, xAxisRotation;
+            bool largeArc, sweep;
+            QPointF endPt;
+            ok = reader.readNumber(rx) && reader.readNumber(ry) && reader.readNumber(xAxisRotation) &&
+                 reader.readFlag(largeArc) && reader.readFlag(sweep) && reader.readPoint(endPt);
+            if (!ok) break;
+            endPt += origin;
+
+            accumulator.add(arcBounds(current, endPt, rx, ry, xAxisRotation, largeArc, sweep));
+            current = lastCtrlPt = endPt;
+            break;
+        }
+        case 'Z':
+            current = lastCtrlPt = subpathStart;
+            break;
+        default:
+            ok = false; // 未知命令
+            break;
+        }
+
+        if (!ok) break;
+    }
+
+    return accumulator.bounds();
+}
+
+bool SVGScanner::scan(const QString &fileName)
+{
+    QFile file {fileName};
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Failed to open file for scanning";
+        clear();
+        return false;
+    }
+
+    return scan(&file);
+}
+
+bool SVGScanner::scan(QIODevice *device)
+{
+    clear();
+
+    QXmlStreamReader reader {device};
+    bool isRoot {true};
+
+    // 各层元素到文档坐标系的变换，与traverse()一样只保存当前路径上的各层，内存占用与嵌套深度成正比
+    m_transforms.push_back(QTransform {});
+
+    while (!reader.atEnd()) {
+        const QXmlStreamReader::TokenType token {reader.readNext()};
+        if (token == QXmlStreamReader::EndElement) {
+            m_transforms.pop_back();
+            continue;
+        }
+        if (token != QXmlStreamReader::StartElement)
+            continue;
+
+        SVGElementType type {svgElementType(reader.name())};
+        ++m_elementCounts[static_cast<std::size_t>(type)];
+
+        const QXmlStreamAttributes attributes {reader.attributes()};
+        auto attribute {[&](QStringView name) { return attributes.value(name); }};
+
+        // 元素自身的transform先作用，再依次应用各祖先的transform
+        const QTransform transform {parseTransform(attribute(u"transform")) * m_transforms.back()};
+        m_transforms.push_back(transform);
+
+        if (isRoot) {
+            scanViewBox(attribute(u"viewBox"), attribute(u"width"), attribute(u"height"));
+            isRoot = false;
+        }
+
+        scanPaint(attribute(u"fill"));
+        scanPaint(attribute(u"stroke"));
+        scanPaint(attribute(u"stop-color"));
+        scanStyle(attribute(u"style"));
+
+        // 计算图形元素的包围盒。如果属性值无效或不存在该属性，则结果为0。
+        QRectF bounds;
+        switch (type) {
+        case SVGElementType::Rect:
+            bounds = QRectF {attribute(u"x").toDouble(), attribute(u"y").toDouble(),
+                             attribute(u"width").toDouble(), attribute(u"height").toDouble()};
+            break;
+        case SVGElementType::Circle: {
+            qreal r {attribute(u"r").toDouble()};
+            bounds = QRectF {attribute(u"cx").toDouble() - r, attribute(u"cy").toDouble() - r, 2 * r, 2 * r};
+            break;
+        }
+        case SVGElementType::Ellipse: {
+            qreal rx {attribute(u"rx").toDouble()};
+            qreal ry {attribute(u"ry").toDouble()};
+            bounds = QRectF {attribute(u"cx").toDouble() - rx, attribute(u"cy").toDouble() - ry, 2 * rx, 2 * ry};
+            break;
+        }
+        case SVGElementType::Line:
+            bounds = QRectF {QPointF {attribute(u"x1").toDouble(), attribute(u"y1").toDouble()},
+                             QPointF {attribute(u"x2").toDouble(), attribute(u"y2").toDouble()}}
+                             .normalized();
+            break;
+        case SVGElementType::Polyline:
+        case SVGElementType::Polygon:
+            bounds = pointsBounds(attribute(u"points"));
+            break;
+        case SVGElementType::Path:
+            bounds = pathBounds(attribute(u"d"));
+            break;
+        default:
+            continue;
+        }
+
+        m_elements.push_back({type, transform.mapRect(bounds)});
+    }
+
+    if (reader.hasError()) {
+        qWarning() << "Failed to scan SVG XML data:" << reader.errorString();
+        return false;
+    }
+
+    return true;
+}
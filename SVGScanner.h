@@ -0,0 +1,67 @@
+#pragma once
+
+#include "SVGElementType.h"
+
+#include <QColor>
+#include <QIODevice>
+#include <QRectF>
+#include <QRgb>
+#include <QTransform>
+
+#include <array>
+#include <unordered_set>
+#include <vector>
+
+class SVGScanner
+{
+    // 只扫描元数据(viewBox、各元素包围盒、元素计数、用到的颜色与渐变)，不经过QSvgRenderer与DOM，
+    // 也不构造QPainterPath、SVGPen、SVGBrush。直接以QXmlStreamReader读取原始SVG文件。
+    // 同一个SVGScanner可反复用于扫描多个文件，容器的已分配空间会被复用。
+
+public:
+    struct ElementInfo {
+        SVGElementType type {SVGElementType::Unknown};
+        // 文档坐标系(与viewBox()相同)下几何图形的包围盒，已应用元素自身及各祖先的transform，不含描边宽度。
+        // 曲线、圆弧以及旋转、斜切后的包围盒均取保守估计
+        QRectF bounds;
+    };
+
+private:
+    QRectF m_viewBox;
+    std::vector<ElementInfo> m_elements;
+    std::array<qsizetype, svgElementTypeCount> m_elementCounts {};
+    std::unordered_set<QRgb> m_colors;
+    std::unordered_set<QString> m_gradients;
+    std::vector<QTransform> m_transforms; // 扫描时的变换栈
+
+    void clear();
+    void scanViewBox(QStringView viewBox, QStringView width, QStringView height);
+    void scanPaint(QStringView paint);
+    void scanStyle(QStringView style);
+
+    static bool parseRgb(QStringView paint, QColor &color);
+    static QRectF arcBounds(const QPointF &startPt, const QPointF &endPt, qreal rx, qreal ry, qreal xAxisRotation,
+                            bool largeArc, bool sweep);
+    static QTransform parseTransform(QStringView transform);
+    static QRectF pointsBounds(QStringView points);
+    static QRectF pathBounds(QStringView d);
+
+public:
+    bool scan(const QString &fileName);
+    bool scan(QIODevice *device);
+
+    // 根元素的viewBox。未指定viewBox时取(0, 0, width, height)
+    QRectF viewBox() const { return m_viewBox; }
+
+    // 各图形元素(rect/circle/ellipse/line/polyline/polygon/path)，按文档顺序
+    const std::vector<ElementInfo> &elements() const { return m_elements; }
+
+    // 某种元素出现的次数，未知元素计入SVGElementType::Unknown
+    qsizetype elementCount(SVGElementType type) const { return m_elementCounts[static_cast<std::size_t>(type)]; }
+
+    // fill、stroke、stop-color中用到的颜色
+    const std::unordered_set<QRgb> &colors() const { return m_colors; }
+
+    // 以url(#id)引用的渐变id
+    const std::unordered_set<QString> &gradients() const { return m_gradients; }
+};
@@ -19,7 +19,8 @@ void SVGTransform::parseTransform(QStringView transform)
     dx = list[4].toDouble();
     dy = list[5].toDouble();
 
-    setMatrix(m11, m12, 0, m21, m22, 0, dx, dy, 1);
+    // 与已有变换复合：新变换作用于当前(上层)坐标系之内
+    QTransform::operator=(QTransform {m11, m12, m21, m22, dx, dy} * *this);
 }
 
 void SVGTransform::syncWithAttributes(const QDomNamedNodeMap &attributes)
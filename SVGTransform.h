@@ -8,5 +8,6 @@ class SVGTransform : public QTransform
     void parseTransform(QStringView transform);
 
 public:
+    // 将属性中的transform复合到当前变换上(而非替换)，以支持嵌套<g>的变换叠加
     void syncWithAttributes(const QDomNamedNodeMap &attributes);
 };
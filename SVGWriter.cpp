@@ -0,0 +1,533 @@
+#include "SVGWriter.h"
+
+#include <QDebug>
+
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <iterator>
+
+// 缓冲区积累到该大小后写入设备
+static constexpr qsizetype FlushThreshold {64 * 1024};
+
+// 取值通常在[0, 1]附近的数值(不透明度、渐变的offset与objectBoundingBox坐标、miter比例)保留的小数位数。
+// 这些数值不是坐标，不随setPrecision()变化，否则低精度时会被量化为0或1
+static constexpr int FractionPrecision {4};
+
+// 以fixed格式输出数值，并去掉多余的字符：1.500 -> 1.5，0.5 -> .5，-0.5 -> -.5，-0 -> 0
+static std::string_view formatNumber(std::array<char, 400> &buffer, qreal value, int precision)
+{
+    if (!std::isfinite(value))
+        value = 0;
+
+    auto [end, ec] {std::to_chars(buffer.data(), buffer.data() + buffer.size(), value, std::chars_format::fixed, precision)};
+    if (ec != std::errc {})
+        return "0";
+
+    char *begin {buffer.data()};
+
+    // 去掉小数部分末尾的0
+    if (precision > 0) {
+        while (end[-1] == '0') --end;
+        if (end[-1] == '.') --end;
+    }
+
+    // -0 -> 0
+    if (end - begin == 2 && begin[0] == '-' && begin[1] == '0')
+        ++begin;
+
+    // 去掉整数部分的0
+    if (end - begin > 1 && begin[0] == '0' && begin[1] == '.')
+        ++begin;
+    else if (end - begin > 2 && begin[0] == '-' && begin[1] == '0' && begin[2] == '.') {
+        begin[1] = '-';
+        ++begin;
+    }
+
+    return {begin, static_cast<std::size_t>(end - begin)};
+}
+
+SVGWriter::SVGWriter(QIODevice *device)
+        : m_device {device} {}
+
+void SVGWriter::flush(bool force)
+{
+    if (m_buffer.isEmpty() || (!force && m_buffer.size() < FlushThreshold))
+        return;
+
+    if (m_ok && m_device->write(m_buffer) != m_buffer.size()) {
+        qWarning() << "Failed to write SVG output";
+        m_ok = false;
+    }
+    m_buffer.clear(); // clear()不释放已分配的空间
+}
+
+void SVGWriter::appendNumber(QByteArray &out, qreal value, int precision)
+{
+    std::array<char, 400> buffer;
+    std::string_view number {formatNumber(buffer, value, precision)};
+    out.append(number.data(), static_cast<qsizetype>(number.size()));
+}
+
+void SVGWriter::appendColor(QByteArray &out, const QColor &color)
+{
+    // 能缩写时写成#rgb
+    static constexpr char Digits[] {"0123456789abcdef"};
+    const int channels[] {color.red(), color.green(), color.blue()};
+
+    out.append('#');
+    if (channels[0] % 17 == 0 && channels[1] % 17 == 0 && channels[2] % 17 == 0) {
+        for (int channel: channels)
+            out.append(Digits[channel / 17]);
+    } else {
+        for (int channel: channels) {
+            out.append(Digits[channel >> 4]);
+            out.append(Digits[channel & 0xf]);
+        }
+    }
+}
+
+void SVGWriter::appendStyleClassName(QByteArray &out, qsizetype index)
+{
+    // 以小写字母编号：a, b, ..., z, ba, bb, ...
+    char buffer[16];
+    char *begin {std::end(buffer)};
+    do {
+        *--begin = static_cast<char>('a' + index % 26);
+        index /= 26;
+    } while (index > 0);
+    out.append(begin, std::end(buffer) - begin);
+}
+
+qsizetype SVGWriter::gradientIndex(const QBrush &brush)
+{
+    // 一个文档中的渐变通常很少，线性查找即可。QBrush::operator==()同时比较渐变与变换
+    for (qsizetype i {0}; i < static_cast<qsizetype>(m_gradients.size()); ++i)
+        if (m_gradients[i] == brush)
+            return i;
+
+    m_gradients.push_back(brush);
+    return static_cast<qsizetype>(m_gradients.size()) - 1;
+}
+
+void SVGWriter::appendStyle(QByteArray &out, const ParseResult &parseResult, bool css)
+{
+    // reference: https://www.w3.org/TR/SVGTiny12/painting.html
+    // 只写出与SVG默认值不同的属性。css为true时写成"name:value;"，否则写成表现属性 name="value"
+    auto beginProperty {[&](const char *name) {
+        if (css) {
+            out.append(name);
+            out.append(':');
+        } else {
+            out.append(' ');
+            out.append(name);
+            out.append("=\"");
+        }
+    }};
+    auto endProperty {[&] { out.append(css ? ";" : "\""); }};
+
+    const SVGBrush &brush {parseResult.brush};
+    const SVGPen &pen {parseResult.pen};
+
+    // fill默认为black，fill-opacity默认为1
+    switch (brush.style()) {
+    case Qt::NoBrush:
+        beginProperty("fill");
+        out.append("none");
+        endProperty();
+        break;
+    case Qt::LinearGradientPattern:
+    case Qt::RadialGradientPattern:
+        beginProperty("fill");
+        out.append("url(#g");
+        out.append(QByteArray::number(gradientIndex(brush)));
+        out.append(')');
+        endProperty();
+        break;
+    default: {
+        const QColor color {brush.color()};
+        if (color.rgb() != qRgb(0, 0, 0)) {
+            beginProperty("fill");
+            appendColor(out, color);
+            endProperty();
+        }
+        if (color.alpha() != 255) {
+            beginProperty("fill-opacity");
+            appendNumber(out, color.alphaF(), FractionPrecision);
+            endProperty();
+        }
+        break;
+    }
+    }
+
+    // fill-rule默认为nonzero
+    if (parseResult.painterPath.fillRule() == Qt::OddEvenFill) {
+        beginProperty("fill-rule");
+        out.append("evenodd");
+        endProperty();
+    }
+
+    // stroke默认为none，此时其余stroke属性均无需写出
+    if (pen.style() == Qt::NoPen)
+        return;
+
+    const QColor color {pen.color()};
+    beginProperty("stroke");
+    appendColor(out, color);
+    endProperty();
+
+    if (color.alpha() != 255) {
+        beginProperty("stroke-opacity");
+        appendNumber(out, color.alphaF(), FractionPrecision);
+        endProperty();
+    }
+
+    if (pen.widthF() != 1) {
+        beginProperty("stroke-width");
+        appendNumber(out, pen.widthF(), m_precision);
+        endProperty();
+    }
+
+    if (pen.capStyle() != Qt::FlatCap) {
+        beginProperty("stroke-linecap");
+        out.append(pen.capStyle() == Qt::RoundCap ? "round" : "square");
+        endProperty();
+    }
+
+    if (pen.joinStyle() == Qt::RoundJoin || pen.joinStyle() == Qt::BevelJoin) {
+        beginProperty("stroke-linejoin");
+        out.append(pen.joinStyle() == Qt::RoundJoin ? "round" : "bevel");
+        endProperty();
+    } else if (pen.miterLimit() != 4) {
+        beginProperty("stroke-miterlimit");
+        appendNumber(out, pen.miterLimit(), FractionPrecision);
+        endProperty();
+    }
+
+    if (pen.style() == Qt::CustomDashLine) {
+        // 与SVGPen::parseStrokeDasharray()对应，原样写出dashPattern
+        beginProperty("stroke-dasharray");
+        const QList<qreal> pattern {pen.dashPattern()};
+        for (qsizetype i {0}; i < pattern.size(); ++i) {
+            if (i > 0) out.append(',');
+            appendNumber(out, pattern[i], m_precision);
+        }
+        endProperty();
+
+        if (pen.dashOffset() != 0) {
+            beginProperty("stroke-dashoffset");
+            appendNumber(out, pen.dashOffset(), m_precision);
+            endProperty();
+        }
+    }
+}
+
+void SVGWriter::appendTransform(QByteArray &out, const QTransform &transform, const char *name) const
+{
+    if (transform.isIdentity())
+        return;
+
+    // 变换矩阵的系数不受坐标精度限制，保留足够的有效数字
+    out.append(' ');
+    out.append(name);
+    out.append("=\"matrix(");
+    const qreal values[] {transform.m11(), transform.m12(), transform.m21(), transform.m22(), transform.dx(), transform.dy()};
+    for (int i {0}; i < 6; ++i) {
+        if (i > 0) out.append(',');
+        out.append(QByteArray::number(values[i], 'g', i < 4 ? 9 : m_precision + 6));
+    }
+    out.append(")\"");
+}
+
+void SVGWriter::appendParameters(QByteArray &out, std::initializer_list<qreal> values, bool &lastNumberHasDot) const
+{
+    // 紧凑的数值序列：数值以'-'开头，或以'.'开头且前一个数值已含'.'时，省略分隔符
+    std::array<char, 400> buffer;
+    bool first {true};
+
+    for (qreal value: values) {
+        std::string_view number {formatNumber(buffer, value, m_precision)};
+        if (!first && number.front() != '-' && !(number.front() == '.' && lastNumberHasDot))
+            out.append(' ');
+        out.append(number.data(), static_cast<qsizetype>(number.size()));
+        lastNumberHasDot = number.find('.') != std::string_view::npos;
+        first = false;
+    }
+}
+
+void SVGWriter::appendSegment(char command, std::initializer_list<qreal> absolute, std::initializer_list<qreal> relative)
+{
+    // 分别以绝对与相对坐标格式化参数，取较短者(长度相同时取绝对坐标)
+    m_absoluteParameters.clear();
+    m_relativeParameters.clear();
+    bool absoluteHasDot {false};
+    bool relativeHasDot {false};
+    appendParameters(m_absoluteParameters, absolute, absoluteHasDot);
+    appendParameters(m_relativeParameters, relative, relativeHasDot);
+
+    const bool useRelative {m_relativeParameters.size() < m_absoluteParameters.size()};
+    const QByteArray &parameters {useRelative ? m_relativeParameters : m_absoluteParameters};
+    const char letter {useRelative ? static_cast<char>(command - 'A' + 'a') : command};
+
+    // 与上一命令相同时省略命令字母(M与m之后的坐标分别视为L与l)
+    const char implicitCommand {m_lastCommand == 'M' ? 'L' : m_lastCommand == 'm' ? 'l' : m_lastCommand};
+    if (letter == implicitCommand) {
+        if (parameters.front() != '-' && !(parameters.front() == '.' && m_lastNumberHasDot))
+            m_buffer.append(' ');
+    } else
+        m_buffer.append(letter);
+
+    m_buffer.append(parameters);
+    m_lastCommand = letter;
+    m_lastNumberHasDot = useRelative ? relativeHasDot : absoluteHasDot;
+}
+
+void SVGWriter::appendPathData(const QPainterPath &path)
+{
+    // 坐标先按精度取整，相对坐标由取整后的点相减得到，避免误差沿路径累积
+    m_lastCommand = 0;
+    m_lastNumberHasDot = false;
+
+    QPointF current;
+    auto roundedAt {[&](int i) {
+        const QPainterPath::Element &element {path.elementAt(i)};
+        return QPointF {round(element.x), round(element.y)};
+    }};
+
+    const int count {path.elementCount()};
+    for (int i {0}; i < count;) {
+        switch (path.elementAt(i).type) {
+        case QPainterPath::MoveToElement: {
+            QPointF point {roundedAt(i)};
+            appendSegment('M', {point.x(), point.y()}, {point.x() - current.x(), point.y() - current.y()});
+            current = point;
+            ++i;
+            break;
+        }
+        case QPainterPath::LineToElement: {
+            // QPainterPath不记录子路径是否闭合(closeSubpath()只是添加一个回到起点的LineTo)，
+            // 因此回到起点的LineTo也原样写出，而不是改写为z：开放的折线恰好终止于起点时，端点应使用线帽而非连接
+            QPointF point {roundedAt(i)};
+            if (point.y() == current.y())
+                appendSegment('H', {point.x()}, {point.x() - current.x()});
+            else if (point.x() == current.x())
+                appendSegment('V', {point.y()}, {point.y() - current.y()});
+            else
+                appendSegment('L', {point.x(), point.y()}, {point.x() - current.x(), point.y() - current.y()});
+
+            current = point;
+            ++i;
+            break;
+        }
+        case QPainterPath::CurveToElement: {
+            // CurveToElement之后紧跟两个CurveToDataElement
+            QPointF ctrlPt1 {roundedAt(i)};
+            QPointF ctrlPt2 {roundedAt(i + 1)};
+            QPointF endPt {roundedAt(i + 2)};
+            appendSegment('C',
+                          {ctrlPt1.x(), ctrlPt1.y(), ctrlPt2.x(), ctrlPt2.y(), endPt.x(), endPt.y()},
+                          {ctrlPt1.x() - current.x(), ctrlPt1.y() - current.y(),
+                           ctrlPt2.x() - current.x(), ctrlPt2.y() - current.y(),
+                           endPt.x() - current.x(), endPt.y() - current.y()});
+            current = endPt;
+            i += 3;
+            break;
+        }
+        case QPainterPath::CurveToDataElement:
+            ++i; // 不应单独出现
+            break;
+        }
+    }
+}
+
+void SVGWriter::writeGradients()
+{
+    // reference: https://www.w3.org/TR/SVGTiny12/painting.html#Gradients
+    if (m_gradients.empty())
+        return;
+
+    m_buffer.append("<defs>");
+    for (qsizetype i {0}; i < static_cast<qsizetype>(m_gradients.size()); ++i) {
+        const QGradient &gradient {*m_gradients[i].gradient()};
+        const QTransform &transform {m_gradients[i].transform()};
+        const bool linear {gradient.type() == QGradient::LinearGradient};
+
+        m_buffer.append(linear ? "<linearGradient id=\"g" : "<radialGradient id=\"g");
+        m_buffer.append(QByteArray::number(i));
+        m_buffer.append('"');
+
+        // objectBoundingBox的坐标是包围盒的比例，按固定精度写出；userSpaceOnUse的坐标按坐标精度写出
+        const bool objectBoundingBox {gradient.coordinateMode() == QGradient::ObjectMode ||
+                                      gradient.coordinateMode() == QGradient::ObjectBoundingMode};
+        const int coordinatePrecision {objectBoundingBox ? FractionPrecision : m_precision};
+
+        auto attribute {[&](const char *name, qreal value, int precision) {
+            m_buffer.append(' ');
+            m_buffer.append(name);
+            m_buffer.append("=\"");
+            appendNumber(m_buffer, value, precision);
+            m_buffer.append('"');
+        }};
+
+        // 画刷的变换为相似变换(平移、旋转、均匀缩放)时直接作用于渐变的几何参数，结果是精确的；
+        // 否则写出gradientTransform(SVG 1.1，SVG 1.2 Tiny不支持)
+        const qreal lengthSquared1 {transform.m11() * transform.m11() + transform.m12() * transform.m12()};
+        const qreal lengthSquared2 {transform.m21() * transform.m21() + transform.m22() * transform.m22()};
+        const bool similarity {qFuzzyCompare(lengthSquared1, lengthSquared2) &&
+                               qFuzzyIsNull(transform.m11() * transform.m21() + transform.m12() * transform.m22())};
+        const QTransform &geometryTransform {similarity ? transform : QTransform {}};
+
+        if (linear) {
+            const auto &linearGradient {static_cast<const QLinearGradient &>(gradient)};
+            const QPointF start {geometryTransform.map(linearGradient.start())};
+            const QPointF finalStop {geometryTransform.map(linearGradient.finalStop())};
+            attribute("x1", start.x(), coordinatePrecision);
+            attribute("y1", start.y(), coordinatePrecision);
+            attribute("x2", finalStop.x(), coordinatePrecision);
+            attribute("y2", finalStop.y(), coordinatePrecision);
+        } else {
+            const auto &radialGradient {static_cast<const QRadialGradient &>(gradient)};
+            const QPointF center {geometryTransform.map(radialGradient.center())};
+            const QPointF focalPoint {geometryTransform.map(radialGradient.focalPoint())};
+            attribute("cx", center.x(), coordinatePrecision);
+            attribute("cy", center.y(), coordinatePrecision);
+            attribute("r", radialGradient.radius() * std::sqrt(std::abs(geometryTransform.determinant())), coordinatePrecision);
+            attribute("fx", focalPoint.x(), coordinatePrecision);
+            attribute("fy", focalPoint.y(), coordinatePrecision);
+        }
+
+        if (!similarity)
+            appendTransform(m_buffer, transform, "gradientTransform");
+
+        // gradientUnits默认为objectBoundingBox
+        if (!objectBoundingBox)
+            m_buffer.append(" gradientUnits=\"userSpaceOnUse\"");
+
+        if (gradient.spread() == QGradient::ReflectSpread)
+            m_buffer.append(" spreadMethod=\"reflect\"");
+        else if (gradient.spread() == QGradient::RepeatSpread)
+            m_buffer.append(" spreadMethod=\"repeat\"");
+
+        m_buffer.append('>');
+
+        for (const auto &[offset, color]: gradient.stops()) {
+            m_buffer.append("<stop");
+            attribute("offset", offset, FractionPrecision);
+            m_buffer.append(" stop-color=\"");
+            appendColor(m_buffer, color);
+            m_buffer.append('"');
+            if (color.alpha() != 255) // stop-opacity默认为1
+                attribute("stop-opacity", color.alphaF(), FractionPrecision);
+            m_buffer.append("/>");
+        }
+
+        m_buffer.append(linear ? "</linearGradient>" : "</radialGradient>");
+        flush();
+    }
+    m_buffer.append("</defs>");
+}
+
+void SVGWriter::writeStyleClasses()
+{
+    if (m_styleClassDeclarations.empty())
+        return;
+
+    m_buffer.append("<style>");
+    for (qsizetype i {0}; i < static_cast<qsizetype>(m_styleClassDeclarations.size()); ++i) {
+        m_buffer.append('.');
+        appendStyleClassName(m_buffer, i);
+        m_buffer.append('{');
+        m_buffer.append(m_styleClassDeclarations[i]);
+        m_buffer.append('}');
+        flush();
+    }
+    m_buffer.append("</style>");
+}
+
+bool SVGWriter::write(const std::vector<ParseResult> &parseResults, const QRectF &viewBox)
+{
+    if (!m_device || !m_device->isWritable()) {
+        qWarning() << "SVGWriter: device is not writable";
+        return false;
+    }
+
+    m_ok = true;
+    m_scale = std::pow(10.0, m_precision);
+    m_buffer.clear();
+    m_gradients.clear();
+    m_styleClasses.clear();
+    m_styleClassDeclarations.clear();
+
+    m_buffer.append(R"(<svg xmlns="http://www.w3.org/2000/svg" version="1.2" baseProfile="tiny" viewBox=")");
+    appendNumber(m_buffer, viewBox.x(), m_precision);
+    m_buffer.append(' ');
+    appendNumber(m_buffer, viewBox.y(), m_precision);
+    m_buffer.append(' ');
+    appendNumber(m_buffer, viewBox.width(), m_precision);
+    m_buffer.append(' ');
+    appendNumber(m_buffer, viewBox.height(), m_precision);
+    m_buffer.append("\">");
+
+    // 文档中的<defs>与<style>放在最后：引用可以出现在定义之前，这样只需遍历一次结果
+    QByteArray style;
+    QByteArray groupAttributes;
+    QByteArray currentGroupAttributes;
+    bool groupOpen {false};
+
+    for (const auto &parseResult: parseResults) {
+        if (parseResult.painterPath.isEmpty())
+            continue;
+
+        // 计算该结果所需的<g>属性
+        style.clear();
+        appendStyle(style, parseResult, false);
+
+        groupAttributes.clear();
+        if (m_useStyleClasses && !style.isEmpty()) {
+            auto [it, inserted] {m_styleClasses.try_emplace(style, static_cast<qsizetype>(m_styleClassDeclarations.size()))};
+            if (inserted) {
+                QByteArray declarations;
+                appendStyle(declarations, parseResult, true);
+                declarations.chop(1); // 最后一条声明无需';'
+                m_styleClassDeclarations.push_back(declarations);
+            }
+            groupAttributes.append(" class=\"");
+            appendStyleClassName(groupAttributes, it->second);
+            groupAttributes.append('"');
+        } else
+            groupAttributes.append(style);
+        appendTransform(groupAttributes, parseResult.transform);
+
+        // 样式与上一个结果不同时，另起一个<g>
+        if (!groupOpen || groupAttributes != currentGroupAttributes) {
+            if (groupOpen)
+                m_buffer.append("</g>");
+            groupOpen = !groupAttributes.isEmpty();
+            if (groupOpen) {
+                m_buffer.append("<g");
+                m_buffer.append(groupAttributes);
+                m_buffer.append('>');
+            }
+            std::swap(currentGroupAttributes, groupAttributes);
+        }
+
+        m_buffer.append("<path d=\"");
+        appendPathData(parseResult.painterPath);
+        m_buffer.append('"');
+        if (parseResult.pen.isCosmetic()) // vector-effect不会被继承，写在元素自身上
+            m_buffer.append(" vector-effect=\"non-scaling-stroke\"");
+        m_buffer.append("/>");
+
+        flush();
+    }
+
+    if (groupOpen)
+        m_buffer.append("</g>");
+
+    writeGradients();
+    writeStyleClasses();
+    m_buffer.append("</svg>");
+    flush(true);
+
+    return m_ok;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "SVGParser.h"
+
+#include <QByteArray>
+#include <QIODevice>
+
+#include <algorithm>
+#include <cmath>
+#include <initializer_list>
+#include <unordered_map>
+#include <vector>
+
+class SVGWriter
+{
+    // 将解析结果流式写回精简的SVG，不构建DOM：
+    // - 相邻且样式(及transform)相同的结果合并到同一个<g>中，样式只写一次，且省略与SVG默认值相同的属性
+    // - 坐标按指定精度输出，去掉多余的0与分隔符；路径数据取绝对/相对坐标中较短者，并省略重复的命令字母
+    // - 渐变去重后写入<defs>
+    // 需要将transform烘焙进路径时，请先调用SVGParser::bakeTransforms()。
+
+    using ParseResult = SVGParser::ParseResult;
+
+private:
+    QIODevice *m_device;
+    int m_precision {3};
+    bool m_useStyleClasses {false};
+
+    // 写入状态
+    QByteArray m_buffer; // 待写入设备的数据，积累到一定大小后写入
+    bool m_ok {true};
+    qreal m_scale {1000}; // 10^precision
+    std::vector<QBrush> m_gradients; // 渐变画刷，连同其变换(bakeTransforms()后userSpaceOnUse的渐变带有变换)
+    std::unordered_map<QByteArray, qsizetype> m_styleClasses; // 样式 -> 类的序号
+    std::vector<QByteArray> m_styleClassDeclarations; // 各类的CSS声明
+
+    // 路径数据的写入状态
+    QByteArray m_absoluteParameters;
+    QByteArray m_relativeParameters;
+    char m_lastCommand {0};
+    bool m_lastNumberHasDot {false};
+
+    void flush(bool force = false);
+
+    static void appendNumber(QByteArray &out, qreal value, int precision);
+    static void appendColor(QByteArray &out, const QColor &color);
+    static void appendStyleClassName(QByteArray &out, qsizetype index);
+
+    qsizetype gradientIndex(const QBrush &brush);
+    void appendStyle(QByteArray &out, const ParseResult &parseResult, bool css);
+    void appendTransform(QByteArray &out, const QTransform &transform, const char *name = "transform") const;
+
+    qreal round(qreal value) const { return std::round(value * m_scale) / m_scale; }
+    void appendParameters(QByteArray &out, std::initializer_list<qreal> values, bool &lastNumberHasDot) const;
+    void appendSegment(char command, std::initializer_list<qreal> absolute, std::initializer_list<qreal> relative);
+    void appendPathData(const QPainterPath &path);
+
+    void writeGradients();
+    void writeStyleClasses();
+
+public:
+    explicit SVGWriter(QIODevice *device = nullptr);
+
+    void setDevice(QIODevice *device) { m_device = device; }
+
+    QIODevice *device() const { return m_device; }
+
+    // 坐标(路径、线宽、userSpaceOnUse的渐变坐标)保留的小数位数，取值范围[0, 15]，默认为3。
+    // 不透明度、渐变的offset与objectBoundingBox坐标不受影响，固定保留4位小数
+    void setPrecision(int precision) { m_precision = std::clamp(precision, 0, 15); }
+
+    int precision() const { return m_precision; }
+
+    // 为true时样式写入<style>中的CSS类并以class引用(适合浏览器显示，但SVG 1.2 Tiny渲染器不支持CSS)；
+    // 为false(默认)时样式以表现属性写在<g>上
+    void setUseStyleClasses(bool useStyleClasses) { m_useStyleClasses = useStyleClasses; }
+
+    bool useStyleClasses() const { return m_useStyleClasses; }
+
+    // 写出完整的SVG文档。设备不可写或写入失败时返回false
+    bool write(const std::vector<ParseResult> &parseResults, const QRectF &viewBox);
+};